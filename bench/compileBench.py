@@ -0,0 +1,156 @@
+#!/usr/bin/python3
+#
+# Compile-time and code-size benchmark for large registrars.
+#
+# Generates a registrar translation unit wrapping N synthetic functions
+# of mixed signatures and compiles it (-c only) for each language
+# standard. The same functions without wrappers are compiled as a
+# baseline. Reports (one line of JSON per measurement):
+#
+#   compile time [s], peak compiler memory [kB],
+#   text bytes per wrapped function (wrapped - baseline) / N,
+#   unwind table bytes (.eh_frame, .gcc_except_table)
+#
+# With --noexcept the functions are declared 'noexcept' (C++17).
+#
+#   compileBench.py [-n 100,1000,5000] [-s c++11,c++98] [-c g++] [-O -O2] [-x] [-k dir] [-- extra flags]
+#
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# Return type, argument types, body
+signatures = [
+  ( "int",         [ "int" ],                                    "return a0 + {n};" ),
+  ( "double",      [ "double", "int" ],                          "return a0 * a1 + {n};" ),
+  ( "void",        [ "const char *" ],                           "sink += a0 ? a0[0] : {n};" ),
+  ( "int",         [ "int", "int", "int" ],                      "return a0 + a1 + a2 + {n};" ),
+  ( "std::string", [ "const std::string &" ],                    "return a0;" ),
+  ( "int",         [ "int *", "double" ],                        "return *a0 + (int)a1 + {n};" ),
+  ( "void",        [ "std::string *", "int" ],                   "sink += a0->size() + a1 + {n};" ),
+  ( "const char*", [ "const char *", "double", "int" ],          "sink += a1 + a2 + {n}; return a0;" ),
+  ( "unsigned",    [ "unsigned", "short", "char *" ],            "return a0 + a1 + (a2 ? a2[0] : {n});" ),
+  ( "double",      [ "double &", "std::complex<double>" ],       "a0 += a1.real(); return a0 + {n};" ),
+]
+
+def genSource(n, wrap, nx):
+  lines = []
+  lines.append( "/* generated by compileBench.py -- do not edit */" )
+  lines.append( "#include <iocshDeclWrapper.h>" )
+  lines.append( "#include <string>" )
+  lines.append( "#include <complex>" )
+  lines.append( "static volatile double sink;" )
+  for i in range(n):
+    ret, args, body = signatures[ i % len(signatures) ]
+    parms = ", ".join( "{} a{}".format( t, j ) for j, t in enumerate( args ) )
+    lines.append( "{} bfn{}({}){} {{ {} }}".format( ret, i, parms, " noexcept" if nx else "", body.format( n = i ) ) )
+  if wrap:
+    lines.append( "IOCSH_FUNC_WRAP_REGISTRAR( compileBenchRegister," )
+    for i in range(n):
+      lines.append( "\tIOCSH_FUNC_WRAP( bfn{} );".format( i ) )
+    lines.append( ")" )
+  else:
+    # keep the functions alive without wrapping them
+    lines.append( "void * const compileBenchFuncs[] = {" )
+    for i in range(n):
+      lines.append( "\t(void*)bfn{},".format( i ) )
+    lines.append( "};" )
+  return "\n".join( lines ) + "\n"
+
+# Sum of all sections matching 'pattern'
+def sectionBytes(obj, pattern):
+  out = subprocess.run( [ "size", "-A", "-d", obj ], check = True, capture_output = True, text = True ).stdout
+  tot = 0
+  for l in out.splitlines():
+    m = re.match( "^(" + pattern + ")[ \t]+([0-9]+)", l )
+    if None != m:
+      tot += int( m.group(2) )
+  return tot
+
+# Executable sections
+def textBytes(obj):
+  return sectionBytes( obj, "[.]text[^ ]*" )
+
+# Unwind tables
+def ehBytes(obj):
+  return sectionBytes( obj, "[.]eh_frame|[.]gcc_except_table[^ ]*" )
+
+# Returns (seconds, peak rss in kB)
+def compile(cmd):
+  then = time.monotonic()
+  p    = subprocess.Popen( cmd )
+  pid, status, ru = os.wait4( p.pid, 0 )
+  dt   = time.monotonic() - then
+  p.returncode = os.waitstatus_to_exitcode( status )
+  if 0 != p.returncode:
+    raise RuntimeError( "compilation failed: {}".format( " ".join( cmd ) ) )
+  return dt, ru.ru_maxrss
+
+def emit(d):
+  print( json.dumps( d ) )
+  sys.stdout.flush()
+
+def main():
+  here = os.path.dirname( os.path.abspath( __file__ ) )
+  ap   = argparse.ArgumentParser( description = "Compile-time and code-size benchmark" )
+  ap.add_argument( "-n", "--nfuncs", default = "100,1000,5000", help = "comma-separated function counts" )
+  ap.add_argument( "-s", "--std",    default = "c++11,c++98",   help = "comma-separated language standards" )
+  ap.add_argument( "-c", "--cxx",    default = os.environ.get( "CXX", "g++" ) )
+  ap.add_argument( "-O", "--opt",    default = "-O2" )
+  ap.add_argument( "-x", "--noexcept", action = "store_true", help = "declare the functions 'noexcept' (C++17)" )
+  ap.add_argument( "-I", "--include", action = "append", default = None,
+                   help = "include directories (default: module and bench/stub)" )
+  ap.add_argument( "-k", "--keep",   default = None, help = "keep generated files in this directory" )
+  ap.add_argument( "flags", nargs = "*", help = "extra compiler flags" )
+  opts = ap.parse_args()
+
+  incs = opts.include
+  if None == incs:
+    incs = [ os.path.join( here, ".." ), os.path.join( here, "stub" ) ]
+
+  tmp  = None
+  wdir = opts.keep
+  if None == wdir:
+    tmp  = tempfile.TemporaryDirectory()
+    wdir = tmp.name
+  else:
+    os.makedirs( wdir, exist_ok = True )
+
+  emit( { "bench": "meta", "suite": "compileBench", "cxx": opts.cxx, "opt": opts.opt, "noexcept": opts.noexcept, "flags": opts.flags } )
+
+  for n in [ int(x) for x in opts.nfuncs.split(",") ]:
+    for std in opts.std.split(","):
+      res = {}
+      for wrap in [ False, True ]:
+        nam = "gen{}_{}_{}".format( n, std.replace( "+", "x" ), "wrap" if wrap else "base" )
+        src = os.path.join( wdir, nam + ".cc" )
+        obj = os.path.join( wdir, nam + ".o"  )
+        with open( src, "w" ) as f:
+          f.write( genSource( n, wrap, opts.noexcept ) )
+        cmd  = [ opts.cxx, "-std=" + std, opts.opt, "-c", "-o", obj, src ]
+        cmd += [ "-I" + i for i in incs ]
+        cmd += opts.flags
+        res[wrap] = compile( cmd ) + ( textBytes( obj ), ehBytes( obj ) )
+      emit( {
+        "bench":               "compile",
+        "std":                 std,
+        "functions":           n,
+        "compile_s":           round( res[True][0], 3 ),
+        "baseline_compile_s":  round( res[False][0], 3 ),
+        "peak_rss_kb":         res[True][1],
+        "baseline_peak_rss_kb":res[False][1],
+        "text_bytes":          res[True][2],
+        "baseline_text_bytes": res[False][2],
+        "text_bytes_per_func": round( ( res[True][2] - res[False][2] ) / n, 1 ),
+        "eh_bytes":            res[True][3],
+        "baseline_eh_bytes":   res[False][3],
+        "eh_bytes_per_func":   round( ( res[True][3] - res[False][3] ) / n, 1 ),
+        "compile_ms_per_func": round( 1000.0 * ( res[True][0] - res[False][0] ) / n, 3 ),
+      } )
+
+main()
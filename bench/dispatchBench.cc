@@ -0,0 +1,260 @@
+/*
+ * Benchmark: cost of a call through the generated iocsh wrappers for
+ * each argument conversion, the cost of printing results and the cost
+ * of registering a wrapper. The '.nothrow' variants use functions
+ * marked non-throwing (NoThrowFunc; C++11 and later). 'call.complex.invalid'
+ * measures a failing conversion (error messages go to stderr).
+ *
+ * Every measurement is emitted as one line of JSON on stdout:
+ *
+ *   {"bench":"call.int","unit":"ns/call","value":12.3,"iterations":1000000}
+ *
+ * The first line describes the build ("bench":"meta").
+ * Output printed by the wrappers themselves goes to /dev/null.
+ *
+ *   dispatchBench [iterations] [repetitions]
+ */
+
+#include <iocshDeclWrapper.h>
+#include <epicsStdio.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <complex>
+#include <vector>
+
+/* Keep the optimizer from discarding results */
+static volatile size_t sink;
+
+void                 benchVoid     ()                                   { sink = sink + 1; }
+int                  benchInt      (int a)                              { return a + 1; }
+int                  benchIntNoThrow(int a)                             { return a + 1; }
+size_t               benchCStrNoThrow(const char *s)                    { return s ? s[0] : 0; }
+int                  benchInt3     (int a, int b, int c)                { return a + b + c; }
+double               benchDouble   (double a)                           { return a * 2.0; }
+size_t               benchCStr     (const char *s)                      { return s ? s[0] : 0; }
+size_t               benchMStr     (char *s)                            { return s ? s[0] : 0; }
+size_t               benchStr      (std::string s)                      { return s.size(); }
+size_t               benchStrCRef  (const std::string &s)               { return s.size(); }
+size_t               benchStrRef   (std::string &s)                     { return s.size(); }
+size_t               benchStrPtr   (std::string *s)                     { return s ? s->size() : 0; }
+double               benchComplex  (std::complex<double> c)             { return c.real(); }
+int                  benchIntPtr   (int *p)                             { return p ? *p : 0; }
+int                  benchIntRef   (int &r)                             { return r; }
+double               benchDoubleRef(double &r)                          { return r; }
+
+int                  benchPrintInt     (int a)                          { return a; }
+double               benchPrintDouble  (double a)                       { return a; }
+const char          *benchPrintCStr    (const char *s)                  { return s; }
+std::string          benchPrintStr     (const std::string &s)           { return s; }
+std::complex<double> benchPrintComplex (std::complex<double> c)         { return c; }
+void                 benchPrintIntRef  (int &r)                         { r++; }
+
+#if __cplusplus >= 201103L
+/* Marked non-throwing: the wrappers omit the exception handlers */
+namespace IocshDeclWrapper {
+template <> struct NoThrowFunc<decltype(benchIntNoThrow),  benchIntNoThrow>  { static const bool value = true; };
+template <> struct NoThrowFunc<decltype(benchCStrNoThrow), benchCStrNoThrow> { static const bool value = true; };
+}
+#endif
+
+/* Absorbs one-time initialization so it does not skew the registration numbers */
+IOCSH_FUNC_WRAP_REGISTRAR( dispatchBenchWarmup,
+	IOCSH_FUNC_WRAP_QUIET( benchVoid      );
+)
+
+IOCSH_FUNC_WRAP_REGISTRAR( dispatchBenchRegister,
+	IOCSH_FUNC_WRAP_QUIET( benchInt       );
+	IOCSH_FUNC_WRAP_QUIET( benchInt3      );
+	IOCSH_FUNC_WRAP_QUIET( benchDouble    );
+	IOCSH_FUNC_WRAP_QUIET( benchCStr      );
+	IOCSH_FUNC_WRAP_QUIET( benchIntNoThrow  );
+	IOCSH_FUNC_WRAP_QUIET( benchCStrNoThrow );
+	IOCSH_FUNC_WRAP_QUIET( benchMStr      );
+	IOCSH_FUNC_WRAP_QUIET( benchStr       );
+	IOCSH_FUNC_WRAP_QUIET( benchStrCRef   );
+	IOCSH_FUNC_WRAP_QUIET( benchStrRef    );
+	IOCSH_FUNC_WRAP_QUIET( benchStrPtr    );
+	IOCSH_FUNC_WRAP_QUIET( benchComplex   );
+	IOCSH_FUNC_WRAP_QUIET( benchIntPtr    );
+	IOCSH_FUNC_WRAP_QUIET( benchIntRef    );
+	IOCSH_FUNC_WRAP_QUIET( benchDoubleRef );
+	IOCSH_FUNC_WRAP( benchPrintInt     );
+	IOCSH_FUNC_WRAP( benchPrintDouble  );
+	IOCSH_FUNC_WRAP( benchPrintCStr    );
+	IOCSH_FUNC_WRAP( benchPrintStr     );
+	IOCSH_FUNC_WRAP( benchPrintComplex );
+	IOCSH_FUNC_WRAP( benchPrintIntRef  );
+)
+
+static void
+emit(const char *bench, const char *unit, double value, unsigned long iterations)
+{
+	printf( "{\"bench\":\"%s\",\"unit\":\"%s\",\"value\":%.2f,\"iterations\":%lu}\n",
+	        bench, unit, value, iterations );
+	fflush( stdout );
+}
+
+static iocshCallFunc
+lookup(const char *name)
+{
+const iocshCmdDef *c = iocshFindCommand( name );
+	if ( ! c ) {
+		fprintf( stderr, "dispatchBench: command '%s' not registered\n", name );
+		exit( 1 );
+	}
+	return c->func;
+}
+
+/* Best of 'reps' runs of 'n' calls; in ns per call */
+static double
+timeCalls(iocshCallFunc fn, const iocshArgBuf *args, unsigned long n, unsigned reps)
+{
+double        best = -1.0;
+unsigned      r;
+unsigned long i;
+
+	for ( r = 0; r < reps; r++ ) {
+		epicsUInt64 then = epicsMonotonicGet();
+		for ( i = 0; i < n; i++ ) {
+			fn( args );
+		}
+		double ns = (double)( epicsMonotonicGet() - then ) / (double)n;
+		if ( best < 0.0 || ns < best ) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+static void
+benchCall(const char *bench, const char *cmd, const iocshArgBuf *args, unsigned long n, unsigned reps)
+{
+	emit( bench, "ns/call", timeCalls( lookup( cmd ), args, n, reps ), n );
+}
+
+/* Reference: the same work without the wrapper */
+static double
+timeDirect(unsigned long n, unsigned reps)
+{
+int (* volatile fn)(int) = benchInt;
+double          best     = -1.0;
+unsigned        r;
+unsigned long   i;
+
+	for ( r = 0; r < reps; r++ ) {
+		epicsUInt64 then = epicsMonotonicGet();
+		for ( i = 0; i < n; i++ ) {
+			sink = sink + fn( (int)i );
+		}
+		double ns = (double)( epicsMonotonicGet() - then ) / (double)n;
+		if ( best < 0.0 || ns < best ) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+static void
+benchRegistration()
+{
+std::vector<IocshDeclWrapper::StartupProfile::Row> rows;
+epicsUInt64                                        then;
+double                                             ns;
+size_t                                             i;
+
+	dispatchBenchWarmup();
+
+	then = epicsMonotonicGet();
+	dispatchBenchRegister();
+	ns   = (double)( epicsMonotonicGet() - then );
+
+	IocshDeclWrapper::StartupProfile::getRegistrars( &rows );
+	for ( i = 0; i < rows.size(); i++ ) {
+		if ( 0 == strcmp( rows[i].name, "dispatchBenchRegister" ) && rows[i].nfuncs ) {
+			emit( "register.function", "ns/function", ns / (double)rows[i].nfuncs, rows[i].nfuncs );
+			emit( "register.allocs", "allocs/function",
+			      (double)rows[i].cost.allocs / (double)rows[i].nfuncs, rows[i].nfuncs );
+		}
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+unsigned long n    = argc > 1 ? strtoul( argv[1], 0, 0 ) : 1000000;
+unsigned      reps = argc > 2 ? (unsigned)strtoul( argv[2], 0, 0 ) : 5;
+FILE         *devNull;
+char          cstr[]    = "hello";
+char          cplx[]    = "1.5 j -2.5";
+iocshArgBuf   a[3];
+
+	if ( ! ( devNull = fopen( "/dev/null", "w" ) ) ) {
+		perror( "dispatchBench: opening /dev/null" );
+		return 1;
+	}
+
+	printf( "{\"bench\":\"meta\",\"suite\":\"dispatchBench\",\"cplusplus\":%ld,\"iterations\":%lu,\"repetitions\":%u}\n",
+	        (long)__cplusplus, n, reps );
+
+	benchRegistration();
+
+	/* From here on wrappers print into /dev/null */
+	epicsSetThreadStdout( devNull );
+
+	emit( "baseline.direct", "ns/call", timeDirect( n, reps ), n );
+
+	benchCall( "call.void", "benchVoid", a, n, reps );
+
+	a[0].ival = 1; a[1].ival = 2; a[2].ival = 3;
+	benchCall( "call.int",           "benchInt",       a, n, reps );
+	benchCall( "call.int.nothrow",   "benchIntNoThrow",a, n, reps );
+	benchCall( "call.int3",          "benchInt3",      a, n, reps );
+	benchCall( "call.int_ptr",       "benchIntPtr",    a, n, reps );
+	benchCall( "call.int_ref",       "benchIntRef",    a, n, reps );
+
+	a[0].dval = 1.5;
+	benchCall( "call.double",        "benchDouble",    a, n, reps );
+	benchCall( "call.double_ref",    "benchDoubleRef", a, n, reps );
+
+	a[0].sval = cstr;
+	benchCall( "call.const_char_ptr",  "benchCStr",    a, n, reps );
+	benchCall( "call.const_char_ptr.nothrow", "benchCStrNoThrow", a, n, reps );
+	benchCall( "call.char_ptr",        "benchMStr",    a, n, reps );
+	benchCall( "call.string",          "benchStr",     a, n, reps );
+	benchCall( "call.const_string_ref","benchStrCRef", a, n, reps );
+	benchCall( "call.string_ref",      "benchStrRef",  a, n, reps );
+	benchCall( "call.string_ptr",      "benchStrPtr",  a, n, reps );
+
+	a[0].sval = cplx;
+	benchCall( "call.complex",         "benchComplex", a, n, reps );
+	a[0].sval = cstr;
+	benchCall( "call.complex.invalid", "benchComplex", a, n / 10 ? n / 10 : 1, reps );
+
+	a[0].ival = 42;
+	benchCall( "print.int",          "benchPrintInt",     a, n, reps );
+	benchCall( "print.int_ref_arg",  "benchPrintIntRef",  a, n, reps );
+	a[0].dval = 3.25;
+	benchCall( "print.double",       "benchPrintDouble",  a, n, reps );
+	a[0].sval = cstr;
+	benchCall( "print.const_char_ptr", "benchPrintCStr",  a, n, reps );
+	benchCall( "print.string",       "benchPrintStr",     a, n, reps );
+	a[0].sval = cplx;
+	benchCall( "print.complex",      "benchPrintComplex", a, n, reps );
+
+	/* Instrumentation overhead */
+	a[0].ival = 1;
+	iocshCmd( "var iocshWrapStatsEnable 0" );
+	benchCall( "call.int.nostats",   "benchInt",       a, n, reps );
+	iocshCmd( "var iocshWrapStatsEnable 1" );
+	iocshCmd( "var iocshWrapTraceEnable 1" );
+	benchCall( "call.int.trace",     "benchInt",       a, n, reps );
+	iocshCmd( "var iocshWrapTraceEnable 0" );
+
+	epicsSetThreadStdout( 0 );
+	fclose( devNull );
+	return 0;
+}
@@ -0,0 +1,77 @@
+/* Micro-benchmark: printf-style PrintFmts vs. NumFmt number formatting */
+
+#include <iocshDeclWrapper.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+using namespace IocshDeclWrapper;
+
+static double
+now()
+{
+struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (double)ts.tv_sec + 1.0E-9 * (double)ts.tv_nsec;
+}
+
+/* Keep the optimizer from discarding the output */
+static volatile size_t sink;
+
+template <typename T, typename P>
+static double
+run(const std::vector<T> &vals, unsigned loops)
+{
+PrintBuffer out;
+double      then = now();
+unsigned    l;
+size_t      i;
+
+	for ( l = 0; l < loops; l++ ) {
+		for ( i = 0; i < vals.size(); i++ ) {
+			P::print( out, vals[i] );
+			if ( 0 == (i & 7) ) {
+				sink = sink + out.size();
+				out.clear();
+			}
+		}
+	}
+	out.clear();
+	return 1.0E9 * ( now() - then ) / (double)loops / (double)vals.size();
+}
+
+template <typename T>
+static void
+bench(const char *name, const std::vector<T> &vals, unsigned loops)
+{
+double printfNs = run< T, PrintFmtsPrinter<T> >( vals, loops );
+double numfmtNs = run< T, DefaultPrinter<T>   >( vals, loops );
+	printf( "%-8s printf: %8.1f ns  numfmt: %8.1f ns  speedup: %5.2f%s\n",
+	        name, printfNs, numfmtNs, printfNs / numfmtNs,
+	        NumFmt<T>::value ? "" : "  (NumFmt not available)" );
+}
+
+int
+main(int argc, char **argv)
+{
+unsigned             n     = argc > 1 ? (unsigned)strtoul( argv[1], 0, 0 ) : 100000;
+unsigned             loops = argc > 2 ? (unsigned)strtoul( argv[2], 0, 0 ) : 10;
+std::vector<int>     ivals;
+std::vector<long>    lvals;
+std::vector<double>  dvals;
+unsigned             i;
+
+	srand( 1 );
+	for ( i = 0; i < n; i++ ) {
+		ivals.push_back( rand() - RAND_MAX/2 );
+		lvals.push_back( (long)rand() * (long)rand() );
+		dvals.push_back( (double)(rand() - RAND_MAX/2) / (double)(rand() + 1) );
+	}
+
+	printf( "%u values, %u loops (time per value)\n", n, loops );
+	bench( "int",    ivals, loops );
+	bench( "long",   lvals, loops );
+	bench( "double", dvals, loops );
+	return 0;
+}
@@ -0,0 +1,514 @@
+/*
+ * Benchmark: cost of the object lookup in wrapped member functions
+ * (IOCSH_MEMBER_WRAP) for maps of 10 ... 100k objects. The same
+ * objects are kept in a std::map ('plain'; every call looks the object up)
+ * and a TrackedObjectMap ('cached'; see MapGeneration, ObjectCache); 'registry'
+ * uses an ObjectRegistry and 'concurrent' a ConcurrentObjectRegistry.
+ * Access patterns:
+ *
+ *   same: every call addresses the same object
+ *   ws16: round-robin over 16 objects
+ *   all:  round-robin over all objects of the map
+ *
+ * The member verifies that it was invoked on the right object; the maps
+ * are refilled with new objects for every size, and objects of the
+ * TrackedObjectMap are replaced and removed, which checks that the
+ * cache is invalidated.
+ *
+ * In addition the bare lookup ('lookup.*'; all objects in random order)
+ * and insertion ('insert.*') are compared for std::map, std::unordered_map
+ * (both keyed by std::string), ObjectRegistry and ConcurrentObjectRegistry
+ * ('concurrent_registry'; lookup inside a ReadGuard), and the ObjectRegistry's
+ * removal, handles and iteration are verified.
+ *
+ * 'broadcast.*' calls a member on all objects with a single command
+ * (objName '*'; compare with 'member.*.all'); 'broadcast.registry.print'
+ * also builds and prints the result table (into /dev/null). Every object
+ * must have been called exactly once per broadcast and the table must
+ * list the matching objects and their results.
+ *
+ * Results are printed as JSON lines, e.g.,
+ *
+ *   {"bench":"member.cached.same","objects":1000,"unit":"ns/call","value":20.1,"iterations":1000000,"errors":0}
+ *
+ * The exit status is nonzero if any error was detected.
+ *
+ *   objectBench [iterations] [repetitions]
+ *
+ * Wrapping of member functions requires C++11; the C++98 build does nothing.
+ */
+
+#include <iocshDeclWrapper.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <epicsStdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#if __cplusplus >= 201103L
+
+#include <unordered_map>
+
+static unsigned long objErrors;
+
+class BenchObj {
+public:
+	unsigned long id;
+	unsigned long touched;
+
+	BenchObj(unsigned long id)
+	: id( id ),
+	  touched( 0 )
+	{
+	}
+
+	void check(int expected)
+	{
+		if ( (unsigned long)expected != id ) {
+			objErrors++;
+		}
+	}
+
+	int ident(int incr)
+	{
+		touched += incr;
+		return (int)id;
+	}
+};
+
+typedef std::map<const std::string, BenchObj*> PlainMap;
+
+typedef IocshDeclWrapper::TrackedObjectMap<BenchObj> TrackedMap;
+typedef std::unordered_map<std::string, BenchObj*> HashMap;
+typedef IocshDeclWrapper::ObjectRegistry<BenchObj>  Registry;
+typedef IocshDeclWrapper::ConcurrentObjectRegistry<BenchObj> ConcurrentRegistry;
+
+static PlainMap   plainMap;
+static TrackedMap trackedMap;
+static Registry   registry;
+static ConcurrentRegistry concurrentRegistry;
+
+IOCSH_FUNC_WRAP_REGISTRAR( objectBenchRegister,
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( BenchObj, check, , &plainMap   ), , "plainCheck",  false, "objName" );
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( BenchObj, check, , &trackedMap ), , "cachedCheck", false, "objName" );
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( BenchObj, check, , &registry   ), , "registryCheck", false, "objName" );
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( BenchObj, check, , &concurrentRegistry ), , "concurrentCheck", false, "objName" );
+	IOCSH_MEMBER_REGISTER_WRAPPER( &plainMap,           BenchObj, ident, , "plainIdent",         false, "incr" );
+	IOCSH_MEMBER_REGISTER_WRAPPER( &registry,           BenchObj, ident, , "registryIdent",      false, "incr" );
+	IOCSH_MEMBER_REGISTER_WRAPPER( &concurrentRegistry, BenchObj, ident, , "concurrentIdent",    false, "incr" );
+	IOCSH_MEMBER_REGISTER_WRAPPER( &registry,           BenchObj, ident, , "registryIdentPrint", true,  "incr" );
+)
+
+static std::vector<std::string> names;
+static std::vector<int>         ids;
+static std::vector<size_t>      shuffled;
+static std::vector<BenchObj*>   objs;
+static unsigned long            broadcasts;
+
+/* Replace all objects; ids are unique across rounds */
+static void
+fill(size_t nobjs, unsigned long round)
+{
+PlainMap::iterator it;
+char               nam[64];
+size_t             i;
+
+	for ( i = 0; i < names.size(); i++ ) {
+		concurrentRegistry.remove( names[i].c_str() );
+	}
+	for ( it = plainMap.begin(); it != plainMap.end(); ++it ) {
+		delete it->second;
+	}
+	plainMap.clear();
+	trackedMap.clear();
+	registry.clear();
+	names.clear();
+	ids.clear();
+	shuffled.clear();
+	objs.clear();
+	broadcasts = 0;
+	for ( i = 0; i < nobjs; i++ ) {
+		BenchObj *o = new BenchObj( round * 1000000UL + i );
+		snprintf( nam, sizeof(nam), "channel-object-%06lu", (unsigned long)i );
+		names.push_back( nam );
+		ids.push_back( (int)o->id );
+		plainMap[ nam ]   = o;
+		trackedMap.add( nam, o );
+		registry.add( nam, o );
+		concurrentRegistry.add( nam, o );
+		shuffled.push_back( i );
+		objs.push_back( o );
+	}
+	/* same order every run */
+	srand( 1 );
+	for ( i = nobjs; i > 1; i-- ) {
+		std::swap( shuffled[i - 1], shuffled[ (size_t)rand() % i ] );
+	}
+}
+
+/* Best of 'reps' runs of 'n' calls cycling over the first 'span' objects; in ns per call */
+static double
+timeCalls(const char *cmd, size_t span, unsigned long n, unsigned reps)
+{
+iocshCallFunc fn   = iocshFindCommand( cmd )->func;
+double        best = -1.0;
+iocshArgBuf   args[2];
+unsigned      r;
+unsigned long i;
+size_t        j;
+
+	for ( r = 0; r < reps; r++ ) {
+		epicsUInt64 then = epicsMonotonicGet();
+		for ( i = 0, j = 0; i < n; i++ ) {
+			args[0].sval = const_cast<char*>( names[j].c_str() );
+			args[1].ival = ids[j];
+			fn( args );
+			if ( ++j == span ) {
+				j = 0;
+			}
+		}
+		double ns = (double)( epicsMonotonicGet() - then ) / (double)n;
+		if ( best < 0.0 || ns < best ) {
+			best = ns;
+		}
+	}
+	return best;
+}
+
+static void
+bench(const char *variant, const char *pattern, size_t nobjs, size_t span, unsigned long n, unsigned reps)
+{
+unsigned long errs = objErrors;
+char          nam[64];
+double        ns;
+
+	snprintf( nam, sizeof(nam), "%sCheck", variant );
+	ns   = timeCalls( nam, span, n, reps );
+	errs = objErrors - errs;
+	snprintf( nam, sizeof(nam), "member.%s.%s", variant, pattern );
+	printf( "{\"bench\":\"%s\",\"objects\":%lu,\"unit\":\"ns/call\",\"value\":%.2f,\"iterations\":%lu,\"errors\":%lu}\n",
+	        nam, (unsigned long)nobjs, ns, n, errs );
+	fflush( stdout );
+}
+
+/* Best of 'reps' runs of broadcasts to all objects; in ns per object */
+static double
+timeBroadcast(const char *cmd, size_t nobjs, unsigned long n, unsigned reps)
+{
+iocshCallFunc fn   = iocshFindCommand( cmd )->func;
+unsigned long nb   = n / nobjs ? n / nobjs : 1;
+double        best = -1.0;
+char          all[] = "*";
+iocshArgBuf   args[2];
+unsigned      r;
+unsigned long i;
+
+	args[0].sval = all;
+	args[1].ival = 1;
+	for ( r = 0; r < reps; r++ ) {
+		epicsUInt64 then = epicsMonotonicGet();
+		for ( i = 0; i < nb; i++ ) {
+			fn( args );
+		}
+		double ns = (double)( epicsMonotonicGet() - then ) / (double)( nb * nobjs );
+		if ( best < 0.0 || ns < best ) {
+			best = ns;
+		}
+	}
+	broadcasts += reps * nb;
+	for ( i = 0; i < nobjs; i++ ) {
+		if ( objs[i]->touched != broadcasts ) {
+			objErrors++;
+		}
+	}
+	return best;
+}
+
+static void
+benchBroadcast(const char *variant, const char *cmd, size_t nobjs, unsigned long n, unsigned reps)
+{
+unsigned long errs = objErrors;
+char          nam[64];
+double        ns;
+
+	ns   = timeBroadcast( cmd, nobjs, n, reps );
+	errs = objErrors - errs;
+	snprintf( nam, sizeof(nam), "broadcast.%s", variant );
+	printf( "{\"bench\":\"%s\",\"objects\":%lu,\"unit\":\"ns/object\",\"value\":%.2f,\"iterations\":%lu,\"errors\":%lu}\n",
+	        nam, (unsigned long)nobjs, ns, n / nobjs ? n / nobjs : 1, errs );
+	fflush( stdout );
+}
+
+/* The table of a broadcast lists (only) the matching objects and their results */
+static void
+checkBroadcast()
+{
+using IocshDeclWrapper::DropBraces;
+IocshDeclWrapper::BroadcastTable<int> t;
+size_t                                i;
+
+	t = IOCSH_MBCAST_WRAPPER( BenchObj, ident, , &concurrentRegistry )( "channel-object-00000?", 0 );
+	if ( t.rows.size() != ( names.size() < 10 ? names.size() : 10 ) || t.failed ) {
+		objErrors++;
+	}
+	for ( i = 0; i < t.rows.size(); i++ ) {
+		const char *nam = t.name( t.rows[i] );
+		size_t      idx = strtoul( nam + strlen( "channel-object-" ), 0, 10 );
+		if ( idx >= names.size() || names[idx] != nam || (unsigned long)t.vals[ t.rows[i].val ] != objs[idx]->id ) {
+			objErrors++;
+		}
+	}
+	t = IOCSH_MBCAST_WRAPPER( BenchObj, ident, , &registry )( "nothing*", 0 );
+	if ( ! t.rows.empty() ) {
+		objErrors++;
+	}
+}
+
+static void
+emit(const char *bench, size_t nobjs, const char *unit, double value, unsigned long iterations)
+{
+	printf( "{\"bench\":\"%s\",\"objects\":%lu,\"unit\":\"%s\",\"value\":%.2f,\"iterations\":%lu,\"errors\":0}\n",
+	        bench, (unsigned long)nobjs, unit, value, iterations );
+	fflush( stdout );
+}
+
+template <typename M>
+static BenchObj *
+lookupObj(const M &m, const char *nam)
+{
+	return m.at( nam );
+}
+
+static BenchObj *
+lookupObj(const ConcurrentRegistry &m, const char *nam)
+{
+ConcurrentRegistry::ReadGuard guard( &m );
+	return m.at( nam );
+}
+
+/* Lookup by 'const char *' as the wrapper does it; in ns per lookup */
+template <typename M>
+static double
+timeLookups(const M &m, unsigned long n, unsigned reps)
+{
+double        best = -1.0;
+unsigned long sum  = 0;
+unsigned      r;
+unsigned long i;
+size_t        j;
+
+	for ( r = 0; r < reps; r++ ) {
+		epicsUInt64 then = epicsMonotonicGet();
+		for ( i = 0, j = 0; i < n; i++ ) {
+			sum += lookupObj( m, names[ shuffled[j] ].c_str() )->id;
+			if ( ++j == names.size() ) {
+				j = 0;
+			}
+		}
+		double ns = (double)( epicsMonotonicGet() - then ) / (double)n;
+		if ( best < 0.0 || ns < best ) {
+			best = ns;
+		}
+	}
+	if ( sum == 0 ) {
+		objErrors++;
+	}
+	return best;
+}
+
+template <typename M>
+static double
+timeInserts(M *m)
+{
+epicsUInt64 then = epicsMonotonicGet();
+size_t      j;
+	for ( j = 0; j < names.size(); j++ ) {
+		(*m)[ names[j] ] = objs[j];
+	}
+	return (double)( epicsMonotonicGet() - then ) / (double)names.size();
+}
+
+template <typename R>
+static double
+timeAdds(R *m)
+{
+epicsUInt64 then = epicsMonotonicGet();
+size_t      j;
+	for ( j = 0; j < names.size(); j++ ) {
+		m->add( names[j].c_str(), objs[j] );
+	}
+	return (double)( epicsMonotonicGet() - then ) / (double)names.size();
+}
+
+static void
+benchContainers(size_t nobjs, unsigned long n, unsigned reps)
+{
+HashMap            hashMap;
+PlainMap           map;
+Registry           reg;
+ConcurrentRegistry creg;
+
+	emit( "insert.map",           nobjs, "ns/insert", timeInserts( &map ),     nobjs );
+	emit( "insert.unordered_map", nobjs, "ns/insert", timeInserts( &hashMap ), nobjs );
+	emit( "insert.registry",      nobjs, "ns/insert", timeAdds( &reg ),        nobjs );
+	emit( "insert.concurrent_registry", nobjs, "ns/insert", timeAdds( &creg ), nobjs );
+	emit( "lookup.map",           nobjs, "ns/lookup", timeLookups( map,     n, reps ), n );
+	emit( "lookup.unordered_map", nobjs, "ns/lookup", timeLookups( hashMap, n, reps ), n );
+	emit( "lookup.registry",      nobjs, "ns/lookup", timeLookups( reg,     n, reps ), n );
+	emit( "lookup.concurrent_registry", nobjs, "ns/lookup", timeLookups( creg, n, reps ), n );
+}
+
+/* Objects replaced in (or removed from) the TrackedMap must never be found in the cache */
+static void
+checkTracked()
+{
+iocshCallFunc fn = iocshFindCommand( "cachedCheck" )->func;
+iocshArgBuf   args[2];
+BenchObj      tmp( 0 );
+size_t        i, n = names.size() < 16 ? names.size() : 16;
+
+	for ( i = 0; i < n; i++ ) {
+		args[0].sval = const_cast<char*>( names[i].c_str() );
+		/* cache the object, replace it, call again (must hit 'tmp'), restore */
+		args[1].ival = ids[i];
+		fn( args );
+		tmp.id = objs[i]->id + 1;
+		if ( trackedMap.replace( names[i].c_str(), &tmp ) != objs[i] ) {
+			objErrors++;
+		}
+		args[1].ival = (int)tmp.id;
+		fn( args );
+		if ( trackedMap.replace( names[i].c_str(), objs[i] ) != &tmp ) {
+			objErrors++;
+		}
+		args[1].ival = ids[i];
+		fn( args );
+		/* removed objects are not found; re-adding works */
+		if (    ! trackedMap.remove( names[i].c_str() )
+		     || trackedMap.find( names[i].c_str() )
+		     || ! trackedMap.add( names[i].c_str(), objs[i] )
+		     || trackedMap.add( names[i].c_str(), objs[i] ) ) {
+			objErrors++;
+		}
+		fn( args );
+	}
+	if ( trackedMap.replace( "no-such-object", &tmp ) || trackedMap.size() != names.size() ) {
+		objErrors++;
+	}
+}
+
+/* Remove every other object and verify lookups, handles and iteration */
+static void
+checkRegistry()
+{
+std::vector<Registry::Handle> handles;
+size_t                        i, n = names.size();
+
+	for ( i = 0; i < n; i++ ) {
+		handles.push_back( registry.handle( names[i].c_str() ) );
+		if ( registry.get( handles[i] ) != objs[i] || registry.add( names[i].c_str(), 0 ).valid() ) {
+			objErrors++;
+		}
+	}
+	for ( i = 0; i < n; i += 2 ) {
+		if ( ! ( ( i & 2 ) ? registry.remove( handles[i] ) : registry.remove( names[i].c_str() ) ) ) {
+			objErrors++;
+		}
+	}
+	for ( i = 0; i < n; i++ ) {
+		bool gone = ! ( i & 1 );
+		if (    gone != ! registry.find( names[i].c_str() )
+		     || gone != ! registry.get( handles[i] )
+		     || ( ! gone && strcmp( registry.name( handles[i] ), names[i].c_str() ) ) ) {
+			objErrors++;
+		}
+	}
+	i = 0;
+	for ( const Registry::Entry &e : registry ) {
+		if ( e.obj != plainMap[ e.name ] ) {
+			objErrors++;
+		}
+		i++;
+	}
+	if ( i != n / 2 || registry.size() != n / 2 ) {
+		objErrors++;
+	}
+	/* re-adding a name yields a new handle; the old one stays invalid */
+	for ( i = 0; i < n; i += 2 ) {
+		if ( ! registry.add( names[i].c_str(), objs[i] ).valid() || registry.get( handles[i] ) ) {
+			objErrors++;
+		}
+	}
+	if ( registry.size() != n ) {
+		objErrors++;
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+unsigned long n     = argc > 1 ? strtoul( argv[1], 0, 0 ) : 1000000;
+unsigned      reps  = argc > 2 ? (unsigned)strtoul( argv[2], 0, 0 ) : 3;
+unsigned long errs  = 0;
+unsigned long round = 0;
+size_t        nobjs;
+const char   *variants[] = { "plain", "cached", "registry", "concurrent" };
+size_t        v;
+FILE         *devNull;
+
+	if ( ! ( devNull = fopen( "/dev/null", "w" ) ) ) {
+		perror( "objectBench: opening /dev/null" );
+		return 1;
+	}
+
+	printf( "{\"bench\":\"meta\",\"suite\":\"objectBench\",\"cplusplus\":%ld,\"iterations\":%lu,\"repetitions\":%u,\"cache_slots\":%d}\n",
+	        (long)__cplusplus, n, reps, IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE );
+
+	objectBenchRegister();
+
+	for ( nobjs = 10; nobjs <= 100000; nobjs *= 10 ) {
+		size_t ws = nobjs < 16 ? nobjs : 16;
+		/* populate the cache, then replace all objects: nothing stale may be found */
+		fill( nobjs, ++round );
+		timeCalls( "cachedCheck", nobjs, nobjs, 1 );
+		fill( nobjs, ++round );
+		checkTracked();
+		checkRegistry();
+		for ( v = 0; v < sizeof(variants)/sizeof(variants[0]); v++ ) {
+			bench( variants[v], "same", nobjs, 1,     n, reps );
+			bench( variants[v], "ws16", nobjs, ws,    n, reps );
+			bench( variants[v], "all",  nobjs, nobjs, n, reps );
+		}
+		benchContainers( nobjs, n, reps );
+		checkBroadcast();
+		benchBroadcast( "plain",      "plainIdent",      nobjs, n, reps );
+		benchBroadcast( "registry",   "registryIdent",   nobjs, n, reps );
+		benchBroadcast( "concurrent", "concurrentIdent", nobjs, n, reps );
+		epicsSetThreadStdout( devNull );
+		benchBroadcast( "registry.print", "registryIdentPrint", nobjs, n, reps );
+		epicsSetThreadStdout( 0 );
+	}
+	fill( 0, ++round );
+	fclose( devNull );
+
+	if ( ( errs = objErrors ) ) {
+		fprintf( stderr, "objectBench: %lu errors detected\n", errs );
+	}
+	return errs ? 1 : 0;
+}
+
+#else
+
+int
+main(int argc, char **argv)
+{
+	printf( "{\"bench\":\"meta\",\"suite\":\"objectBench\",\"cplusplus\":%ld,\"skipped\":\"requires C++11\"}\n",
+	        (long)__cplusplus );
+	return 0;
+}
+
+#endif
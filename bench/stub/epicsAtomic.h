@@ -0,0 +1,98 @@
+#ifndef IOCSH_STUB_EPICSATOMIC_H
+#define IOCSH_STUB_EPICSATOMIC_H
+
+/* Stand-in for epicsAtomic.h based on the gcc/clang __atomic builtins */
+
+#include <stddef.h>
+
+typedef void *EpicsAtomicPtrT;
+
+static inline size_t epicsAtomicIncrSizeT(size_t *p)
+{
+	return __atomic_add_fetch( p, 1, __ATOMIC_SEQ_CST );
+}
+
+static inline size_t epicsAtomicDecrSizeT(size_t *p)
+{
+	return __atomic_sub_fetch( p, 1, __ATOMIC_SEQ_CST );
+}
+
+static inline size_t epicsAtomicAddSizeT(size_t *p, size_t d)
+{
+	return __atomic_add_fetch( p, d, __ATOMIC_SEQ_CST );
+}
+
+static inline size_t epicsAtomicSubSizeT(size_t *p, size_t d)
+{
+	return __atomic_sub_fetch( p, d, __ATOMIC_SEQ_CST );
+}
+
+static inline size_t epicsAtomicGetSizeT(const size_t *p)
+{
+	return __atomic_load_n( p, __ATOMIC_SEQ_CST );
+}
+
+static inline void epicsAtomicSetSizeT(size_t *p, size_t v)
+{
+	__atomic_store_n( p, v, __ATOMIC_SEQ_CST );
+}
+
+static inline size_t epicsAtomicCmpAndSwapSizeT(size_t *p, size_t o, size_t n)
+{
+	__atomic_compare_exchange_n( p, &o, n, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+	return o;
+}
+
+static inline int epicsAtomicIncrIntT(int *p)
+{
+	return __atomic_add_fetch( p, 1, __ATOMIC_SEQ_CST );
+}
+
+static inline int epicsAtomicDecrIntT(int *p)
+{
+	return __atomic_sub_fetch( p, 1, __ATOMIC_SEQ_CST );
+}
+
+static inline int epicsAtomicGetIntT(const int *p)
+{
+	return __atomic_load_n( p, __ATOMIC_SEQ_CST );
+}
+
+static inline void epicsAtomicSetIntT(int *p, int v)
+{
+	__atomic_store_n( p, v, __ATOMIC_SEQ_CST );
+}
+
+static inline int epicsAtomicCmpAndSwapIntT(int *p, int o, int n)
+{
+	__atomic_compare_exchange_n( p, &o, n, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+	return o;
+}
+
+static inline EpicsAtomicPtrT epicsAtomicGetPtrT(const EpicsAtomicPtrT *p)
+{
+	return __atomic_load_n( p, __ATOMIC_SEQ_CST );
+}
+
+static inline void epicsAtomicSetPtrT(EpicsAtomicPtrT *p, EpicsAtomicPtrT v)
+{
+	__atomic_store_n( p, v, __ATOMIC_SEQ_CST );
+}
+
+static inline EpicsAtomicPtrT epicsAtomicCmpAndSwapPtrT(EpicsAtomicPtrT *p, EpicsAtomicPtrT o, EpicsAtomicPtrT n)
+{
+	__atomic_compare_exchange_n( p, &o, n, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+	return o;
+}
+
+static inline void epicsAtomicReadMemoryBarrier(void)
+{
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+}
+
+static inline void epicsAtomicWriteMemoryBarrier(void)
+{
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+}
+
+#endif
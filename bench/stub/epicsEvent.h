@@ -0,0 +1,24 @@
+#ifndef IOCSH_STUB_EPICSEVENT_H
+#define IOCSH_STUB_EPICSEVENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct epicsEventOSD *epicsEventId;
+
+typedef enum {
+	epicsEventEmpty,
+	epicsEventFull
+} epicsEventInitialState;
+
+epicsEventId epicsEventMustCreate(epicsEventInitialState initialState);
+void         epicsEventDestroy(epicsEventId id);
+void         epicsEventSignal(epicsEventId id);
+void         epicsEventMustWait(epicsEventId id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
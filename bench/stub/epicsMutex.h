@@ -0,0 +1,19 @@
+#ifndef IOCSH_STUB_EPICSMUTEX_H
+#define IOCSH_STUB_EPICSMUTEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct epicsMutexParm *epicsMutexId;
+
+epicsMutexId epicsMutexMustCreate(void);
+void         epicsMutexDestroy(epicsMutexId id);
+void         epicsMutexMustLock(epicsMutexId id);
+void         epicsMutexUnlock(epicsMutexId id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
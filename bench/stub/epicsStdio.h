@@ -0,0 +1,20 @@
+#ifndef IOCSH_STUB_EPICSSTDIO_H
+#define IOCSH_STUB_EPICSSTDIO_H
+
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int   epicsStdoutPrintf(const char *fmt, ...);
+int   epicsStdoutPuts(const char *s);
+FILE *epicsGetStdout(void);
+void  epicsSetThreadStdout(FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
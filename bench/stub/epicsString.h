@@ -0,0 +1,15 @@
+#ifndef IOCSH_STUB_EPICSSTRING_H
+#define IOCSH_STUB_EPICSSTRING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char *epicsStrDup(const char *s);
+int   epicsStrGlobMatch(const char *str, const char *pattern);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
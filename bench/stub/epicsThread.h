@@ -0,0 +1,32 @@
+#ifndef IOCSH_STUB_EPICSTHREAD_H
+#define IOCSH_STUB_EPICSTHREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*EPICSTHREADFUNC)(void *parm);
+
+typedef struct epicsThreadOSD *epicsThreadId;
+
+typedef enum {
+	epicsThreadStackSmall,
+	epicsThreadStackMedium,
+	epicsThreadStackBig
+} epicsThreadStackSizeClass;
+
+#define epicsThreadPriorityLow     10
+#define epicsThreadPriorityMedium  50
+#define epicsThreadPriorityHigh    90
+
+/* Threads are always detached; the returned id is only good for testing against NULL */
+epicsThreadId epicsThreadCreate(const char *name, unsigned int priority, unsigned int stackSize,
+                                EPICSTHREADFUNC funptr, void *parm);
+unsigned int  epicsThreadGetStackSize(epicsThreadStackSizeClass size);
+void          epicsThreadSleep(double seconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef IOCSH_STUB_EPICSTHREADPOOL_H
+#define IOCSH_STUB_EPICSTHREADPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	unsigned int initialThreads;
+	unsigned int maxThreads;
+	unsigned int workerStack;
+	unsigned int workerPriority;
+} epicsThreadPoolConfig;
+
+typedef struct epicsThreadPool epicsThreadPool;
+typedef struct epicsJob        epicsJob;
+
+typedef enum {
+	epicsJobModeRun,
+	epicsJobModeCleanup
+} epicsJobMode;
+
+typedef void (*epicsJobFunction)(void *arg, epicsJobMode mode);
+
+void             epicsThreadPoolConfigDefaults(epicsThreadPoolConfig *opts);
+/* Workers are started on demand (up to maxThreads); the stub pool cannot be destroyed */
+epicsThreadPool *epicsThreadPoolCreate(epicsThreadPoolConfig *opts);
+
+epicsJob        *epicsJobCreate(epicsThreadPool *pool, epicsJobFunction cb, void *user);
+/* A running job is freed when its callback returns */
+void             epicsJobDestroy(epicsJob *job);
+int              epicsJobQueue(epicsJob *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef IOCSH_STUB_EPICSTIME_H
+#define IOCSH_STUB_EPICSTIME_H
+
+#include <epicsTypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Monotonic time in ns */
+epicsUInt64 epicsMonotonicGet(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef IOCSH_STUB_EPICSTYPES_H
+#define IOCSH_STUB_EPICSTYPES_H
+
+#include <stdint.h>
+
+typedef int8_t   epicsInt8;
+typedef uint8_t  epicsUInt8;
+typedef int16_t  epicsInt16;
+typedef uint16_t epicsUInt16;
+typedef int32_t  epicsInt32;
+typedef uint32_t epicsUInt32;
+typedef int64_t  epicsInt64;
+typedef uint64_t epicsUInt64;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef IOCSH_STUB_EPICSVERSION_H
+#define IOCSH_STUB_EPICSVERSION_H
+
+/* The stub provides what EPICS 7 provides (e.g., epicsThreadPool) */
+#define EPICS_VERSION      7
+#define EPICS_REVISION     0
+#define EPICS_MODIFICATION 8
+#define EPICS_PATCH_LEVEL  0
+
+#define VERSION_INT(V,R,M,P) ( ((V)<<24) | ((R)<<16) | ((M)<<8) | (P) )
+#define EPICS_VERSION_INT    VERSION_INT( EPICS_VERSION, EPICS_REVISION, EPICS_MODIFICATION, EPICS_PATCH_LEVEL )
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef IOCSH_STUB_ERRLOG_H
+#define IOCSH_STUB_ERRLOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int errlogPrintf(const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
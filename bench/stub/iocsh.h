@@ -0,0 +1,70 @@
+#ifndef IOCSH_STUB_IOCSH_H
+#define IOCSH_STUB_IOCSH_H
+
+/*
+ * Minimal stand-in for EPICS iocsh; only what the benchmarks
+ * need (see iocshStub.cc).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	iocshArgInt,
+	iocshArgDouble,
+	iocshArgString,
+	iocshArgPdbbase,
+	iocshArgArgv,
+	iocshArgPersistentString,
+	iocshArgStringRecord,
+	iocshArgStringPath
+} iocshArgType;
+
+typedef union iocshArgBuf {
+	int     ival;
+	double  dval;
+	char   *sval;
+	void   *vval;
+	struct {
+		int    ac;
+		char **av;
+	}       aval;
+} iocshArgBuf;
+
+typedef struct iocshArg {
+	const char   *name;
+	iocshArgType  type;
+} iocshArg;
+
+typedef struct iocshFuncDef {
+	const char             *name;
+	int                     nargs;
+	const iocshArg * const *arg;
+	const char             *usage;
+} iocshFuncDef;
+
+typedef void (*iocshCallFunc)(const iocshArgBuf *argBuf);
+
+typedef struct iocshVarDef {
+	const char   *name;
+	iocshArgType  type;
+	void         *pval;
+} iocshVarDef;
+
+typedef struct iocshCmdDef {
+	iocshFuncDef const *pFuncDef;
+	iocshCallFunc       func;
+} iocshCmdDef;
+
+void               iocshRegister(const iocshFuncDef *piocshFuncDef, iocshCallFunc func);
+void               iocshRegisterVariable(const iocshVarDef *piocshVarDef);
+const iocshCmdDef *iocshFindCommand(const char *name);
+/* Execute a command line; arguments are separated by blanks or commas */
+int                iocshCmd(const char *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,478 @@
+/*
+ * Minimal stand-in for the parts of EPICS libCom/iocsh used by
+ * iocshDeclWrapper.h so that the benchmarks build without EPICS base.
+ * Commands are kept in a std::map; iocshCmd() does a simple split
+ * at blanks/commas (double quotes group) - there is no redirection,
+ * no macro expansion etc.
+ */
+#include <iocsh.h>
+#include <epicsStdio.h>
+#include <epicsString.h>
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsThreadPool.h>
+#include <errlog.h>
+#include <map>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fnmatch.h>
+#include <pthread.h>
+
+typedef std::map<std::string, iocshCmdDef>         CmdMap;
+typedef std::map<std::string, const iocshVarDef *> VarMap;
+
+static CmdMap &
+cmds()
+{
+static CmdMap m;
+	return m;
+}
+
+static VarMap &
+vars()
+{
+static VarMap m;
+	return m;
+}
+
+/* Per-thread, like the real thing */
+static __thread FILE *theStdout = 0;
+
+extern "C" {
+
+void
+iocshRegister(const iocshFuncDef *piocshFuncDef, iocshCallFunc func)
+{
+iocshCmdDef c;
+	c.pFuncDef = piocshFuncDef;
+	c.func     = func;
+	cmds()[ piocshFuncDef->name ] = c;
+}
+
+void
+iocshRegisterVariable(const iocshVarDef *piocshVarDef)
+{
+	for ( ; piocshVarDef->name; piocshVarDef++ ) {
+		vars()[ piocshVarDef->name ] = piocshVarDef;
+	}
+}
+
+const iocshCmdDef *
+iocshFindCommand(const char *name)
+{
+CmdMap::iterator it = cmds().find( name );
+	return it == cmds().end() ? 0 : &it->second;
+}
+
+FILE *
+epicsGetStdout(void)
+{
+	return theStdout ? theStdout : stdout;
+}
+
+void
+epicsSetThreadStdout(FILE *f)
+{
+	theStdout = f;
+}
+
+int
+epicsStdoutPrintf(const char *fmt, ...)
+{
+va_list ap;
+int     rval;
+	va_start( ap, fmt );
+	rval = vfprintf( epicsGetStdout(), fmt, ap );
+	va_end( ap );
+	return rval;
+}
+
+int
+epicsStdoutPuts(const char *s)
+{
+	return fprintf( epicsGetStdout(), "%s\n", s );
+}
+
+int
+errlogPrintf(const char *fmt, ...)
+{
+va_list ap;
+int     rval;
+	va_start( ap, fmt );
+	rval = vfprintf( stderr, fmt, ap );
+	va_end( ap );
+	return rval;
+}
+
+char *
+epicsStrDup(const char *s)
+{
+	return strdup( s );
+}
+
+int
+epicsStrGlobMatch(const char *str, const char *pattern)
+{
+	return 0 == fnmatch( pattern, str, 0 );
+}
+
+epicsMutexId
+epicsMutexMustCreate(void)
+{
+pthread_mutexattr_t  a;
+pthread_mutex_t     *m = new pthread_mutex_t;
+	pthread_mutexattr_init( &a );
+	pthread_mutexattr_settype( &a, PTHREAD_MUTEX_RECURSIVE );
+	pthread_mutex_init( m, &a );
+	pthread_mutexattr_destroy( &a );
+	return reinterpret_cast<epicsMutexId>( m );
+}
+
+void
+epicsMutexDestroy(epicsMutexId id)
+{
+pthread_mutex_t *m = reinterpret_cast<pthread_mutex_t*>( id );
+	pthread_mutex_destroy( m );
+	delete m;
+}
+
+void
+epicsMutexMustLock(epicsMutexId id)
+{
+	pthread_mutex_lock( reinterpret_cast<pthread_mutex_t*>( id ) );
+}
+
+void
+epicsMutexUnlock(epicsMutexId id)
+{
+	pthread_mutex_unlock( reinterpret_cast<pthread_mutex_t*>( id ) );
+}
+
+typedef struct epicsEventOSD {
+	pthread_mutex_t mtx;
+	pthread_cond_t  cond;
+	int             full;
+} Event;
+
+epicsEventId
+epicsEventMustCreate(epicsEventInitialState initialState)
+{
+Event *ev = new Event;
+	pthread_mutex_init( &ev->mtx, 0 );
+	pthread_cond_init( &ev->cond, 0 );
+	ev->full = ( epicsEventFull == initialState );
+	return ev;
+}
+
+void
+epicsEventDestroy(epicsEventId id)
+{
+	pthread_cond_destroy( &id->cond );
+	pthread_mutex_destroy( &id->mtx );
+	delete id;
+}
+
+void
+epicsEventSignal(epicsEventId id)
+{
+	pthread_mutex_lock( &id->mtx );
+	id->full = 1;
+	pthread_cond_signal( &id->cond );
+	pthread_mutex_unlock( &id->mtx );
+}
+
+void
+epicsEventMustWait(epicsEventId id)
+{
+	pthread_mutex_lock( &id->mtx );
+	while ( ! id->full ) {
+		pthread_cond_wait( &id->cond, &id->mtx );
+	}
+	id->full = 0;
+	pthread_mutex_unlock( &id->mtx );
+}
+
+struct ThreadStart {
+	EPICSTHREADFUNC func;
+	void           *parm;
+};
+
+static void *
+threadStart(void *arg)
+{
+ThreadStart s = *static_cast<ThreadStart*>( arg );
+	delete static_cast<ThreadStart*>( arg );
+	s.func( s.parm );
+	return 0;
+}
+
+epicsThreadId
+epicsThreadCreate(const char *name, unsigned int priority, unsigned int stackSize, EPICSTHREADFUNC funptr, void *parm)
+{
+pthread_attr_t  a;
+pthread_t       tid;
+ThreadStart    *s = new ThreadStart;
+int             st;
+	(void)name;
+	(void)priority;
+	s->func = funptr;
+	s->parm = parm;
+	pthread_attr_init( &a );
+	pthread_attr_setdetachstate( &a, PTHREAD_CREATE_DETACHED );
+	pthread_attr_setstacksize( &a, stackSize );
+	st = pthread_create( &tid, &a, threadStart, s );
+	pthread_attr_destroy( &a );
+	if ( st ) {
+		delete s;
+		return 0;
+	}
+	return reinterpret_cast<epicsThreadId>( s );
+}
+
+unsigned int
+epicsThreadGetStackSize(epicsThreadStackSizeClass size)
+{
+	switch ( size ) {
+		case epicsThreadStackSmall:  return 128 * 1024;
+		case epicsThreadStackMedium: return 256 * 1024;
+		default:                     break;
+	}
+	return 1024 * 1024;
+}
+
+void
+epicsThreadSleep(double seconds)
+{
+struct timespec ts;
+	if ( seconds < 0.0 ) {
+		seconds = 0.0;
+	}
+	ts.tv_sec  = (time_t)seconds;
+	ts.tv_nsec = (long)( ( seconds - (double)ts.tv_sec ) * 1.0E9 );
+	nanosleep( &ts, 0 );
+}
+
+struct epicsThreadPool {
+	pthread_mutex_t         mtx;
+	pthread_cond_t          work;
+	std::deque<epicsJob*>   queue;
+	epicsThreadPoolConfig   conf;
+	unsigned int            threads;
+	unsigned int            idle;
+};
+
+struct epicsJob {
+	epicsThreadPool  *pool;
+	epicsJobFunction  func;
+	void             *arg;
+	bool              queued;
+	bool              running;
+	bool              freeWhenDone;
+};
+
+void
+epicsThreadPoolConfigDefaults(epicsThreadPoolConfig *opts)
+{
+	opts->initialThreads = 0;
+	opts->maxThreads     = 4;
+	opts->workerStack    = epicsThreadGetStackSize( epicsThreadStackSmall );
+	opts->workerPriority = epicsThreadPriorityMedium;
+}
+
+static void
+poolWorker(void *arg)
+{
+epicsThreadPool *p = static_cast<epicsThreadPool*>( arg );
+epicsJob        *j;
+	pthread_mutex_lock( &p->mtx );
+	for ( ;; ) {
+		while ( p->queue.empty() ) {
+			p->idle++;
+			pthread_cond_wait( &p->work, &p->mtx );
+			p->idle--;
+		}
+		j = p->queue.front();
+		p->queue.pop_front();
+		j->queued  = false;
+		j->running = true;
+		pthread_mutex_unlock( &p->mtx );
+		j->func( j->arg, epicsJobModeRun );
+		pthread_mutex_lock( &p->mtx );
+		j->running = false;
+		if ( j->freeWhenDone ) {
+			delete j;
+		}
+	}
+}
+
+/* Called with the pool locked */
+static bool
+poolStartWorker(epicsThreadPool *p)
+{
+	if ( ! epicsThreadCreate( "poolWorker", p->conf.workerPriority, p->conf.workerStack, poolWorker, p ) ) {
+		return false;
+	}
+	p->threads++;
+	return true;
+}
+
+epicsThreadPool *
+epicsThreadPoolCreate(epicsThreadPoolConfig *opts)
+{
+epicsThreadPool *p = new epicsThreadPool;
+	pthread_mutex_init( &p->mtx, 0 );
+	pthread_cond_init( &p->work, 0 );
+	p->conf    = *opts;
+	p->threads = 0;
+	p->idle    = 0;
+	if ( p->conf.maxThreads < 1 ) {
+		p->conf.maxThreads = 1;
+	}
+	pthread_mutex_lock( &p->mtx );
+	while ( p->threads < std::min( p->conf.initialThreads, p->conf.maxThreads ) && poolStartWorker( p ) )
+		;
+	pthread_mutex_unlock( &p->mtx );
+	return p;
+}
+
+epicsJob *
+epicsJobCreate(epicsThreadPool *pool, epicsJobFunction cb, void *user)
+{
+epicsJob *j = new epicsJob;
+	j->pool         = pool;
+	j->func         = cb;
+	j->arg          = user;
+	j->queued       = false;
+	j->running      = false;
+	j->freeWhenDone = false;
+	return j;
+}
+
+void
+epicsJobDestroy(epicsJob *job)
+{
+epicsThreadPool *p = job->pool;
+	pthread_mutex_lock( &p->mtx );
+	if ( job->queued ) {
+		p->queue.erase( std::find( p->queue.begin(), p->queue.end(), job ) );
+		job->queued = false;
+	}
+	if ( job->running ) {
+		job->freeWhenDone = true;
+		job = 0;
+	}
+	pthread_mutex_unlock( &p->mtx );
+	delete job;
+}
+
+int
+epicsJobQueue(epicsJob *job)
+{
+epicsThreadPool *p = job->pool;
+int              st = 0;
+	pthread_mutex_lock( &p->mtx );
+	if ( ! job->queued ) {
+		p->queue.push_back( job );
+		job->queued = true;
+		/* more pending jobs than idle workers: start another one */
+		if ( p->queue.size() > p->idle && p->threads < p->conf.maxThreads ) {
+			poolStartWorker( p );
+		}
+		if ( 0 == p->threads ) {
+			p->queue.pop_back();
+			job->queued = false;
+			st = -1;
+		} else {
+			pthread_cond_signal( &p->work );
+		}
+	}
+	pthread_mutex_unlock( &p->mtx );
+	return st;
+}
+
+epicsUInt64
+epicsMonotonicGet(void)
+{
+struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (epicsUInt64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int
+iocshCmd(const char *cmd)
+{
+std::vector<std::string>  tok;
+std::string               cur;
+bool                      have = false;
+bool                      quot = false;
+
+	for ( ; *cmd; cmd++ ) {
+		if ( quot ) {
+			if ( '"' == *cmd ) {
+				quot = false;
+			} else {
+				cur += *cmd;
+			}
+		} else if ( '"' == *cmd ) {
+			quot = have = true;
+		} else if ( strchr( " \t\n,()", *cmd ) ) {
+			if ( have ) {
+				tok.push_back( cur );
+				cur.clear();
+				have = false;
+			}
+		} else {
+			cur += *cmd;
+			have = true;
+		}
+	}
+	if ( have ) {
+		tok.push_back( cur );
+	}
+	if ( tok.empty() ) {
+		return 0;
+	}
+
+	if ( "var" == tok[0] && tok.size() > 1 ) {
+		VarMap::iterator it = vars().find( tok[1] );
+		if ( it == vars().end() || iocshArgInt != it->second->type ) {
+			errlogPrintf( "Variable %s not found.\n", tok[1].c_str() );
+			return -1;
+		}
+		if ( tok.size() > 2 ) {
+			*(int*)it->second->pval = strtol( tok[2].c_str(), 0, 0 );
+		} else {
+			epicsStdoutPrintf( "%s = %d\n", tok[1].c_str(), *(int*)it->second->pval );
+		}
+		return 0;
+	}
+
+	const iocshCmdDef *c = iocshFindCommand( tok[0].c_str() );
+	if ( ! c ) {
+		errlogPrintf( "Command %s not found.\n", tok[0].c_str() );
+		return -1;
+	}
+
+	int                      n = c->pFuncDef->nargs;
+	std::vector<iocshArgBuf> buf( n > 0 ? n : 1 );
+
+	for ( int i = 0; i < n; i++ ) {
+		const char *s = (size_t)i + 1 < tok.size() ? tok[i + 1].c_str() : 0;
+		switch ( c->pFuncDef->arg[i]->type ) {
+			case iocshArgInt:    buf[i].ival = s ? strtol( s, 0, 0 ) : 0; break;
+			case iocshArgDouble: buf[i].dval = s ? strtod( s, 0 )    : 0.; break;
+			default:             buf[i].sval = const_cast<char*>( s );    break;
+		}
+	}
+	c->func( &buf[0] );
+	return 0;
+}
+
+}
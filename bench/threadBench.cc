@@ -0,0 +1,759 @@
+/*
+ * Stress test/benchmark: the generated wrappers are invoked from N
+ * threads concurrently (N = 1, 2, 4, ... 64).
+ *
+ *  - throughput: every thread calls a quiet wrapper taking int, double,
+ *    const char * and a (heap-allocated) std::string. The user function
+ *    verifies that it sees exactly the arguments its thread passed.
+ *    The same is repeated with statistics disabled and with tracing
+ *    enabled. Afterwards the statistics' call counter and the records
+ *    in the trace ring are checked.
+ *  - printing:   every thread calls a printing wrapper with a mutable
+ *    argument; the output goes to a per-thread file (epicsSetThreadStdout)
+ *    which is verified afterwards.
+ *  - registry:   every thread calls a wrapped member function on objects
+ *    of a ConcurrentObjectRegistry while a writer thread keeps replacing
+ *    these objects (and adding/removing others). A replaced object is
+ *    marked dead as soon as replace() returns; the member verifies that
+ *    the object it runs on stays alive until it returns (C++11).
+ *    'writercpu' is the CPU time the writer spends per replacement.
+ *  - longread:   as 'registry' but every member call sleeps for 1ms
+ *    (e.g., device I/O) and the writer only replaces objects, i.e., every
+ *    operation waits for read sections. The writer blocks while waiting;
+ *    its CPU time per replacement must stay far below the 1ms (C++11).
+ *  - fanout:     a member which sleeps for 1ms is broadcast to 64 objects
+ *    by a parallel wrapper (IOCSH_MEMBER_WRAP_PARALLEL) with the
+ *    concurrency limit 'iocshWrapParallelMax' set to N. The table printed
+ *    must list every object once (in order) with its result and the
+ *    error of the one object that fails; no more than N calls may be
+ *    in flight at any time (C++11, IOCSH_DECL_WRAPPER_PARALLEL).
+ *
+ * Results are printed as JSON lines, e.g.,
+ *
+ *   {"bench":"mt.quiet","threads":8,"unit":"calls/s","value":1.2e+07,"iterations":100000,"errors":0}
+ *
+ * The exit status is nonzero if any error was detected.
+ *
+ *   threadBench [calls_per_thread] [max_threads]
+ */
+
+/* this is the only translation unit: define iocshWrapTraceSnapshot() */
+#define IOCSH_DECL_WRAPPER_DEFINE_C_API
+#include <iocshDeclWrapper.h>
+#include <epicsStdio.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsAtomic.h>
+#include <epicsTime.h>
+#include <iocsh.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#if __cplusplus >= 201103L
+#define MT_REGISTRY
+#if IOCSH_DECL_WRAPPER_PARALLEL
+#define MT_FANOUT
+#endif
+#endif
+
+#define MAX_THREADS 64
+
+/* Long enough to defeat the small-string optimization */
+#define TAG_FMT "worker-thread-tag-%03d"
+
+static size_t mtErrors;
+
+static void
+mtError()
+{
+	epicsAtomicIncrSizeT( &mtErrors );
+}
+
+int
+mtCall(int id, double val, const char *tag, std::string stag)
+{
+char expected[64];
+	snprintf( expected, sizeof(expected), TAG_FMT, id );
+	if ( val != (double)id * 0.5 || ! tag || strcmp( tag, expected ) || stag != expected ) {
+		mtError();
+	}
+	return id;
+}
+
+/* Prints the result and the mutable argument */
+int
+mtPrint(int &val, int id)
+{
+	val += id;
+	return val * 2;
+}
+
+IOCSH_FUNC_WRAP_REGISTRAR( threadBenchRegister,
+	IOCSH_FUNC_WRAP_QUIET( mtCall );
+	IOCSH_FUNC_WRAP( mtPrint );
+)
+
+#ifdef MT_REGISTRY
+#define MT_OBJS 64
+
+class MtObj {
+public:
+	int alive;
+
+	/* Spin a little so that replacements overlap with calls */
+	int touch(int spin)
+	{
+	volatile int i = 0;
+		if ( ! epicsAtomicGetIntT( &alive ) ) {
+			mtError();
+		}
+		while ( i < spin ) {
+			i = i + 1;
+		}
+		if ( ! epicsAtomicGetIntT( &alive ) ) {
+			mtError();
+		}
+		return spin;
+	}
+
+	/* A long read section */
+	int hold(int ms)
+	{
+		if ( ! epicsAtomicGetIntT( &alive ) ) {
+			mtError();
+		}
+		epicsThreadSleep( (double)ms * 1.0E-3 );
+		if ( ! epicsAtomicGetIntT( &alive ) ) {
+			mtError();
+		}
+		return ms;
+	}
+};
+
+static IocshDeclWrapper::ConcurrentObjectRegistry<MtObj> mtRegistry;
+static MtObj                                              mtObjs[2][MT_OBJS];
+static int                                                mtCur[MT_OBJS]; /* registered: mtObjs[mtCur[i]][i] */
+
+IOCSH_FUNC_WRAP_REGISTRAR( threadBenchRegistryRegister,
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( MtObj, touch, , &mtRegistry ), , "mtObjTouch", false, "objName" );
+	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( MtObj, hold,  , &mtRegistry ), , "mtObjHold",  false, "objName" );
+)
+#endif
+
+#ifdef MT_FANOUT
+#define FAN_OBJS 64
+#define FAN_FAIL 13 /* this object's member throws */
+
+static size_t fanInFlight;
+static size_t fanMaxInFlight;
+
+class FanObj {
+public:
+	int    id;
+	size_t calls;
+
+	/* Simulates a slow device access; returns id + val */
+	int ping(int val)
+	{
+	size_t n = epicsAtomicIncrSizeT( &fanInFlight );
+	size_t m;
+		while ( ( m = epicsAtomicGetSizeT( &fanMaxInFlight ) ) < n ) {
+			epicsAtomicCmpAndSwapSizeT( &fanMaxInFlight, m, n );
+		}
+		epicsAtomicIncrSizeT( &calls );
+		epicsThreadSleep( 0.001 );
+		epicsAtomicDecrSizeT( &fanInFlight );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+		if ( FAN_FAIL == id ) {
+			throw std::runtime_error( "device timeout" );
+		}
+#endif
+		return id + val;
+	}
+};
+
+static IocshDeclWrapper::ConcurrentObjectRegistry<FanObj> fanRegistry;
+static FanObj                                              fanObjs[FAN_OBJS];
+
+IOCSH_FUNC_WRAP_REGISTRAR( threadBenchFanoutRegister,
+	IOCSH_MEMBER_WRAP_PARALLEL( &fanRegistry, FanObj, ping, "val" );
+)
+#endif
+
+struct Worker {
+	int            id;
+	unsigned long  calls;
+	iocshCallFunc  fn;
+	bool           print;
+	FILE          *out;
+	epicsEventId   go;
+	epicsEventId   done;
+	char           tag[32];
+};
+
+static void
+workerRun(Worker *w)
+{
+iocshArgBuf   args[4];
+unsigned long i;
+
+	if ( w->print ) {
+		epicsSetThreadStdout( w->out );
+		for ( i = 0; i < w->calls; i++ ) {
+			args[0].ival = (int)i;
+			args[1].ival = w->id;
+			w->fn( args );
+		}
+		epicsSetThreadStdout( 0 );
+	} else {
+		args[0].ival = w->id;
+		args[1].dval = (double)w->id * 0.5;
+		args[2].sval = w->tag;
+		args[3].sval = w->tag;
+		for ( i = 0; i < w->calls; i++ ) {
+			w->fn( args );
+		}
+	}
+}
+
+static void
+workerThread(void *arg)
+{
+Worker *w = static_cast<Worker*>( arg );
+	epicsEventMustWait( w->go );
+	workerRun( w );
+	epicsEventSignal( w->done );
+}
+
+/* Each call must have produced
+ *   <result> ...
+ *   Mutable arguments after execution:
+ *   arg[0]: <val> ...
+ */
+static unsigned long
+verifyPrint(const Worker *w)
+{
+char          line[256];
+unsigned long i;
+unsigned long errs = 0;
+long          v;
+
+	rewind( w->out );
+	for ( i = 0; i < w->calls; i++ ) {
+		long val = (long)i + w->id;
+		if ( ! fgets( line, sizeof(line), w->out ) || 1 != sscanf( line, "%ld", &v ) || v != 2 * val ) {
+			errs++;
+		}
+		if ( ! fgets( line, sizeof(line), w->out ) || strcmp( line, "Mutable arguments after execution:\n" ) ) {
+			errs++;
+		}
+		if ( ! fgets( line, sizeof(line), w->out ) || 1 != sscanf( line, "arg[0]: %ld", &v ) || v != val ) {
+			errs++;
+		}
+	}
+	if ( fgets( line, sizeof(line), w->out ) ) {
+		/* trailing garbage */
+		errs++;
+	}
+	return errs;
+}
+
+/* Returns the elapsed time in seconds */
+static double
+runThreads(Worker *w, int nThreads)
+{
+epicsUInt64 then;
+int         i;
+
+	for ( i = 0; i < nThreads; i++ ) {
+		w[i].go   = epicsEventMustCreate( epicsEventEmpty );
+		w[i].done = epicsEventMustCreate( epicsEventEmpty );
+		if ( ! epicsThreadCreate( "threadBench", epicsThreadPriorityMedium,
+		                          epicsThreadGetStackSize( epicsThreadStackMedium ),
+		                          workerThread, &w[i] ) ) {
+			fprintf( stderr, "threadBench: unable to create thread\n" );
+			exit( 1 );
+		}
+	}
+	then = epicsMonotonicGet();
+	for ( i = 0; i < nThreads; i++ ) {
+		epicsEventSignal( w[i].go );
+	}
+	for ( i = 0; i < nThreads; i++ ) {
+		epicsEventMustWait( w[i].done );
+	}
+	then = epicsMonotonicGet() - then;
+	for ( i = 0; i < nThreads; i++ ) {
+		epicsEventDestroy( w[i].go );
+		epicsEventDestroy( w[i].done );
+	}
+	return (double)then * 1.0E-9;
+}
+
+static void
+emit(const char *bench, int nThreads, const char *unit, double value, unsigned long iterations, unsigned long errors)
+{
+	printf( "{\"bench\":\"%s\",\"threads\":%d,\"unit\":\"%s\",\"value\":%.4g,\"iterations\":%lu,\"errors\":%lu}\n",
+	        bench, nThreads, unit, value, iterations, errors );
+	fflush( stdout );
+}
+
+static unsigned long
+benchQuiet(const char *bench, int nThreads, unsigned long calls)
+{
+Worker        w[MAX_THREADS];
+size_t        errs = epicsAtomicGetSizeT( &mtErrors );
+double        secs;
+int           i;
+
+	for ( i = 0; i < nThreads; i++ ) {
+		w[i].id    = i;
+		w[i].calls = calls;
+		w[i].fn    = iocshFindCommand( "mtCall" )->func;
+		w[i].print = false;
+		w[i].out   = 0;
+		snprintf( w[i].tag, sizeof(w[i].tag), TAG_FMT, i );
+	}
+	secs = runThreads( w, nThreads );
+	errs = epicsAtomicGetSizeT( &mtErrors ) - errs;
+	emit( bench, nThreads, "calls/s", (double)calls * (double)nThreads / secs, calls, errs );
+	return errs;
+}
+
+static unsigned long
+benchPrint(int nThreads, unsigned long calls)
+{
+Worker        w[MAX_THREADS];
+unsigned long errs = 0;
+double        secs;
+int           i;
+
+	for ( i = 0; i < nThreads; i++ ) {
+		w[i].id    = i;
+		w[i].calls = calls;
+		w[i].fn    = iocshFindCommand( "mtPrint" )->func;
+		w[i].print = true;
+		if ( ! ( w[i].out = tmpfile() ) ) {
+			perror( "threadBench: tmpfile" );
+			exit( 1 );
+		}
+	}
+	secs = runThreads( w, nThreads );
+	for ( i = 0; i < nThreads; i++ ) {
+		errs += verifyPrint( &w[i] );
+		fclose( w[i].out );
+	}
+	emit( "mt.print", nThreads, "calls/s", (double)calls * (double)nThreads / secs, calls, errs );
+	return errs;
+}
+
+#ifdef MT_REGISTRY
+/* CPU time used by the calling thread (seconds); 0 if unsupported */
+static double
+threadCpuTime()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+struct timespec ts;
+	if ( 0 == clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) ) {
+		return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0E-9;
+	}
+#endif
+	return 0.0;
+}
+
+struct RegWriter {
+	int           stop;
+	bool          churn;
+	unsigned long ops;
+	double        cpu;
+	epicsEventId  go;
+	epicsEventId  done;
+};
+
+static void
+regWriterThread(void *arg)
+{
+RegWriter    *w = static_cast<RegWriter*>( arg );
+char          nam[32];
+unsigned long k;
+int           i, nxt;
+double        cpu;
+
+	epicsEventMustWait( w->go );
+	cpu = threadCpuTime();
+	for ( k = 0; ! epicsAtomicGetIntT( &w->stop ); k++ ) {
+		MtObj *old;
+		i   = (int)( k % MT_OBJS );
+		nxt = ! mtCur[i];
+		snprintf( nam, sizeof(nam), "mtObj%02d", i );
+		epicsAtomicSetIntT( &mtObjs[nxt][i].alive, 1 );
+		old = mtRegistry.replace( nam, &mtObjs[nxt][i] );
+		if ( old != &mtObjs[ mtCur[i] ][i] ) {
+			mtError();
+		}
+		/* no call may be executing on 'old' anymore */
+		epicsAtomicSetIntT( &old->alive, 0 );
+		mtCur[i] = nxt;
+		/* churn: grow the table (rebuilds) and leave tombstones */
+		snprintf( nam, sizeof(nam), "mtTmp%lu", ( k / 2 ) % 1000 );
+		if ( ! w->churn ) {
+			/* only replace */
+		} else if ( ! ( k & 1 ) ) {
+			if ( ! mtRegistry.add( nam, &mtObjs[0][0] ) ) {
+				mtError();
+			}
+		} else if ( ! mtRegistry.remove( nam ) ) {
+			mtError();
+		}
+		w->ops++;
+	}
+	if ( w->churn && ( k & 1 ) ) {
+		/* added but not removed yet */
+		mtRegistry.remove( nam );
+	}
+	w->cpu = threadCpuTime() - cpu;
+	epicsEventSignal( w->done );
+}
+
+struct RegReader {
+	int            id;
+	unsigned long  calls;
+	iocshCallFunc  fn;
+	int            arg;
+	epicsEventId   go;
+	epicsEventId   done;
+};
+
+static void
+regReaderThread(void *arg)
+{
+RegReader    *r = static_cast<RegReader*>( arg );
+iocshArgBuf   args[2];
+char          nam[32];
+unsigned long i;
+
+	epicsEventMustWait( r->go );
+	for ( i = 0; i < r->calls; i++ ) {
+		snprintf( nam, sizeof(nam), "mtObj%02d", (int)( ( i + r->id ) % MT_OBJS ) );
+		args[0].sval = nam;
+		args[1].ival = r->arg;
+		r->fn( args );
+	}
+	epicsEventSignal( r->done );
+}
+
+static void
+spawn(const char *name, EPICSTHREADFUNC fn, void *arg)
+{
+	if ( ! epicsThreadCreate( name, epicsThreadPriorityMedium,
+	                          epicsThreadGetStackSize( epicsThreadStackMedium ),
+	                          fn, arg ) ) {
+		fprintf( stderr, "threadBench: unable to create thread\n" );
+		exit( 1 );
+	}
+}
+
+/*
+ * Readers (calling member 'cmd' with 'arg') vs. one writer; reports the
+ * readers' throughput, the writer's replacements and its CPU load
+ */
+static unsigned long
+benchRegistry(const char *bench, const char *cmd, int arg, bool churn, int nThreads, unsigned long calls)
+{
+RegReader     r[MAX_THREADS];
+RegWriter     w;
+size_t        errs = epicsAtomicGetSizeT( &mtErrors );
+epicsUInt64   then;
+double        secs;
+char          nam[64];
+int           i;
+
+	w.stop  = 0;
+	w.churn = churn;
+	w.ops   = 0;
+	w.cpu   = 0.0;
+	w.go    = epicsEventMustCreate( epicsEventEmpty );
+	w.done  = epicsEventMustCreate( epicsEventEmpty );
+	for ( i = 0; i < nThreads; i++ ) {
+		r[i].id    = i;
+		r[i].calls = calls;
+		r[i].fn    = iocshFindCommand( cmd )->func;
+		r[i].arg   = arg;
+		r[i].go    = epicsEventMustCreate( epicsEventEmpty );
+		r[i].done  = epicsEventMustCreate( epicsEventEmpty );
+		spawn( "threadBenchRd", regReaderThread, &r[i] );
+	}
+	spawn( "threadBenchWr", regWriterThread, &w );
+	then = epicsMonotonicGet();
+	for ( i = 0; i < nThreads; i++ ) {
+		epicsEventSignal( r[i].go );
+	}
+	epicsEventSignal( w.go );
+	for ( i = 0; i < nThreads; i++ ) {
+		epicsEventMustWait( r[i].done );
+		epicsEventDestroy( r[i].go );
+		epicsEventDestroy( r[i].done );
+	}
+	secs = (double)( epicsMonotonicGet() - then ) * 1.0E-9;
+	epicsAtomicSetIntT( &w.stop, 1 );
+	epicsEventMustWait( w.done );
+	epicsEventDestroy( w.go );
+	epicsEventDestroy( w.done );
+	errs = epicsAtomicGetSizeT( &mtErrors ) - errs;
+	emit( bench, nThreads, "calls/s", (double)calls * (double)nThreads / secs, calls, errs );
+	snprintf( nam, sizeof(nam), "%s.writer", bench );
+	emit( nam, nThreads, "replacements/s", (double)w.ops / secs, w.ops, 0 );
+	snprintf( nam, sizeof(nam), "%s.writercpu", bench );
+	emit( nam, nThreads, "us/replacement", w.ops ? w.cpu * 1.0E6 / (double)w.ops : 0.0, w.ops, 0 );
+	return errs;
+}
+
+static unsigned long
+benchRegistries(int maxThreads, unsigned long calls)
+{
+unsigned long errs = 0;
+char          nam[32];
+int           i, n;
+
+	threadBenchRegistryRegister();
+	for ( i = 0; i < MT_OBJS; i++ ) {
+		snprintf( nam, sizeof(nam), "mtObj%02d", i );
+		mtObjs[0][i].alive = 1;
+		mtRegistry.add( nam, &mtObjs[0][i] );
+	}
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchRegistry( "mt.registry", "mtObjTouch", 100, true, n, calls );
+	}
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchRegistry( "mt.registry.longread", "mtObjHold", 1, false, n, calls / 1000 ? calls / 1000 : 1 );
+	}
+	return errs;
+}
+#endif
+
+#ifdef MT_FANOUT
+/*
+ * Expect
+ *   object    result
+ *   fanObj00  <val> (0x...)
+ *   ...
+ *   fanObj13  Error: Exception -- device timeout
+ *   ...
+ *   64 objects, 1 failed
+ */
+static unsigned long
+verifyFanout(FILE *f, int val)
+{
+char          line[256];
+char          nam[32];
+unsigned long errs = 0;
+unsigned long nobjs, nfailed;
+int           i, v, nfail = 0;
+
+	rewind( f );
+	if ( ! fgets( line, sizeof(line), f ) || strncmp( line, "object", 6 ) ) {
+		errs++;
+	}
+	for ( i = 0; i < FAN_OBJS; i++ ) {
+		snprintf( nam, sizeof(nam), "fanObj%02d ", i );
+		if ( ! fgets( line, sizeof(line), f ) || strncmp( line, nam, strlen( nam ) ) ) {
+			errs++;
+			continue;
+		}
+		if ( strstr( line, "Error:" ) ) {
+			nfail++;
+			if ( FAN_FAIL != i || ! strstr( line, "device timeout" ) ) {
+				errs++;
+			}
+		} else if ( 2 != sscanf( line, "%31s %d", nam, &v ) || v != i + val ) {
+			errs++;
+		}
+	}
+	if (    ! fgets( line, sizeof(line), f )
+	     || 2 != sscanf( line, "%lu objects, %lu failed", &nobjs, &nfailed )
+	     || FAN_OBJS != nobjs
+	     || (unsigned long)nfail != nfailed
+	     || ( IOCSH_DECL_WRAPPER_EXCEPTIONS ? 1 : 0 ) != nfail ) {
+		errs++;
+	}
+	if ( fgets( line, sizeof(line), f ) ) {
+		/* trailing garbage */
+		errs++;
+	}
+	return errs;
+}
+
+/* 'bcasts' broadcasts to all objects with at most 'limit' concurrent calls */
+static unsigned long
+benchFanout(int limit, unsigned long bcasts)
+{
+iocshCallFunc fn   = iocshFindCommand( "FanObj_ping" )->func;
+unsigned long errs = 0;
+iocshArgBuf   args[2];
+char          cmd[64];
+char          pat[] = "fanObj*";
+FILE         *out;
+epicsUInt64   then;
+double        secs;
+unsigned long b;
+int           i;
+
+	if ( ! ( out = tmpfile() ) ) {
+		perror( "threadBench: tmpfile" );
+		exit( 1 );
+	}
+	snprintf( cmd, sizeof(cmd), "var iocshWrapParallelMax %d", limit );
+	iocshCmd( cmd );
+	epicsAtomicSetSizeT( &fanMaxInFlight, 0 );
+	secs = 0.0;
+	for ( b = 0; b < bcasts; b++ ) {
+		for ( i = 0; i < FAN_OBJS; i++ ) {
+			fanObjs[i].calls = 0;
+		}
+		rewind( out );
+		args[0].sval = pat;
+		args[1].ival = (int)b;
+		epicsSetThreadStdout( out );
+		then = epicsMonotonicGet();
+		fn( args );
+		secs += (double)( epicsMonotonicGet() - then ) * 1.0E-9;
+		epicsSetThreadStdout( 0 );
+		fflush( out );
+		for ( i = 0; i < FAN_OBJS; i++ ) {
+			if ( 1 != fanObjs[i].calls ) {
+				errs++;
+			}
+		}
+		errs += verifyFanout( out, (int)b );
+	}
+	fclose( out );
+	if ( epicsAtomicGetSizeT( &fanMaxInFlight ) > (size_t)limit ) {
+		errs++;
+	}
+	emit( "mt.fanout", limit, "ms/broadcast", secs * 1.0E3 / (double)bcasts, bcasts, errs );
+	emit( "mt.fanout.inflight", limit, "calls", (double)epicsAtomicGetSizeT( &fanMaxInFlight ), bcasts, 0 );
+	return errs;
+}
+
+static unsigned long
+benchFanouts(int maxThreads, unsigned long bcasts)
+{
+unsigned long errs = 0;
+char          nam[32];
+int           i, n;
+
+	threadBenchFanoutRegister();
+	for ( i = 0; i < FAN_OBJS; i++ ) {
+		snprintf( nam, sizeof(nam), "fanObj%02d", i );
+		fanObjs[i].id = i;
+		fanRegistry.add( nam, &fanObjs[i] );
+	}
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchFanout( n, bcasts );
+	}
+	return errs;
+}
+#endif
+
+/* The (atomically updated) call counter must not have lost any calls */
+static unsigned long
+checkStats(const char *name, unsigned long expected)
+{
+std::vector<const IocshDeclWrapper::WrapperRegistry::Entry *> v;
+unsigned long                                              calls;
+
+	IocshDeclWrapper::WrapperRegistry::find( &v, name );
+	calls = v.size() ? (unsigned long)epicsAtomicGetSizeT( &v[0]->state->stats.calls ) : 0;
+	emit( "mt.stats.calls", 0, "calls", (double)calls, expected, calls != expected );
+	return calls != expected;
+}
+
+/* Records in the trace ring must not be torn or reordered by concurrent writers */
+static unsigned long
+checkTrace()
+{
+static IocshWrapTraceRecord recs[ IOCSH_DECL_WRAPPER_TRACE_SIZE ];
+size_t                      n    = iocshWrapTraceSnapshot( recs, IOCSH_DECL_WRAPPER_TRACE_SIZE );
+unsigned long               errs = 0;
+char                        tag[32];
+size_t                      i;
+
+	for ( i = 0; i < n; i++ ) {
+		const IocshWrapTraceRecord *r = &recs[i];
+		int                         id;
+		if ( i && r->seq <= recs[i - 1].seq ) {
+			/* out of order or duplicate */
+			errs++;
+		}
+		if ( strcmp( r->name, "mtCall" ) || r->nargs != 4 || r->args[0].type != iocshArgInt ) {
+			errs++;
+			continue;
+		}
+		id = r->args[0].val.ival;
+		snprintf( tag, sizeof(tag), TAG_FMT, id );
+		tag[ IOCSH_DECL_WRAPPER_TRACE_STRLEN - 1 ] = 0;
+		if (    r->args[1].val.dval != (double)id * 0.5
+		     || strcmp( r->args[2].val.sval, tag )
+		     || strcmp( r->args[3].val.sval, tag )
+		     || r->outcome != IocshWrapTraceOK ) {
+			errs++;
+		}
+	}
+	emit( "mt.trace.records", 0, "records", (double)n, n, errs );
+	return errs;
+}
+
+int
+main(int argc, char **argv)
+{
+unsigned long calls      = argc > 1 ? strtoul( argv[1], 0, 0 ) : 100000;
+int           maxThreads = argc > 2 ? atoi( argv[2] ) : MAX_THREADS;
+unsigned long errs       = 0;
+unsigned long expected   = 0;
+int           n;
+
+	if ( maxThreads < 1 || maxThreads > MAX_THREADS ) {
+		maxThreads = MAX_THREADS;
+	}
+
+	printf( "{\"bench\":\"meta\",\"suite\":\"threadBench\",\"cplusplus\":%ld,\"iterations\":%lu,\"max_threads\":%d}\n",
+	        (long)__cplusplus, calls, maxThreads );
+
+	threadBenchRegister();
+
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchQuiet( "mt.quiet", n, calls );
+		expected += calls * (unsigned long)n;
+	}
+	errs += checkStats( "mtCall", expected );
+	iocshCmd( "var iocshWrapStatsEnable 0" );
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchQuiet( "mt.quiet.nostats", n, calls );
+	}
+	iocshCmd( "var iocshWrapStatsEnable 1" );
+	iocshCmd( "var iocshWrapTraceEnable 1" );
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchQuiet( "mt.quiet.trace", n, calls );
+	}
+	iocshCmd( "var iocshWrapTraceEnable 0" );
+	errs += checkTrace();
+	for ( n = 1; n <= maxThreads; n *= 2 ) {
+		errs += benchPrint( n, calls / 10 ? calls / 10 : 1 );
+	}
+#ifdef MT_REGISTRY
+	errs += benchRegistries( maxThreads, calls / 10 ? calls / 10 : 1 );
+#endif
+#ifdef MT_FANOUT
+	errs += benchFanouts( maxThreads, calls / 10000 ? calls / 10000 : 1 );
+#endif
+
+	if ( errs ) {
+		fprintf( stderr, "threadBench: %lu errors detected\n", errs );
+	}
+	return errs ? 1 : 0;
+}
@@ -12,12 +12,25 @@
 #include <epicsExport.h>
 #include <errlog.h>
 #include <iocsh.h>
+#include <epicsMutex.h>
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <epicsVersion.h>
 #include <string>
 #include <stdexcept>
 #include <vector>
+#include <algorithm>
 #include <complex>
+#include <utility>
+#include <new>
+#if __cplusplus >= 201703L
+#include <string_view>
+#include <charconv>
+#endif
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <string.h>
 
 /* Helper templates that automate the generation of infamous boiler-plate code
@@ -76,6 +89,59 @@
  * function is done.
  */
 
+/*
+ * Marks a 'Convert::getArg' (or other function) as non-throwing
+ * (C++11 and later; see NoThrowArg).
+ */
+#ifndef IOCSH_DECL_WRAPPER_NOEXCEPT
+#if __cplusplus >= 201103L
+#define IOCSH_DECL_WRAPPER_NOEXCEPT noexcept
+#else
+#define IOCSH_DECL_WRAPPER_NOEXCEPT
+#endif
+#endif
+
+/* Non-throwing if the (constant) expression 'x' is true (C++11 and later) */
+#ifndef IOCSH_DECL_WRAPPER_NOEXCEPT_IF
+#if __cplusplus >= 201103L
+#define IOCSH_DECL_WRAPPER_NOEXCEPT_IF(x) noexcept(x)
+#else
+#define IOCSH_DECL_WRAPPER_NOEXCEPT_IF(x)
+#endif
+#endif
+
+/*
+ * Are exceptions enabled? Without exceptions conversion failures must
+ * be reported with Context::fail() (requires C++11).
+ */
+#ifndef IOCSH_DECL_WRAPPER_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define IOCSH_DECL_WRAPPER_EXCEPTIONS 1
+#else
+#define IOCSH_DECL_WRAPPER_EXCEPTIONS 0
+#endif
+#endif
+
+#if ! IOCSH_DECL_WRAPPER_EXCEPTIONS && __cplusplus < 201103L
+#error "iocshDeclWrapper.h: building without exceptions requires C++11"
+#endif
+
+/*
+ * Parallel broadcasts of member calls (IOCSH_MEMBER_WRAP_PARALLEL, C++11)
+ * run on an epicsThreadPool (EPICS 3.15 or later, hence the default); define
+ * as 0 to build without (the broadcasts are then sequential).
+ */
+#ifndef IOCSH_DECL_WRAPPER_PARALLEL
+#if defined(VERSION_INT) && defined(EPICS_VERSION_INT)
+#if EPICS_VERSION_INT >= VERSION_INT(3,15,0,0)
+#define IOCSH_DECL_WRAPPER_PARALLEL 1
+#endif
+#endif
+#endif
+#ifndef IOCSH_DECL_WRAPPER_PARALLEL
+#define IOCSH_DECL_WRAPPER_PARALLEL 0
+#endif
+
 namespace IocshDeclWrapper {
 
 /*
@@ -89,6 +155,11 @@ template <typename T> struct is_int;
 		{                            \
 			return  #x ;             \
         }                            \
+		/* default iocshArg name */  \
+		static const char *argName() \
+		{                            \
+			return "<" #x ">";       \
+		}                            \
 	}
 /* All of these are extracted from iocshArgBuf->ival */
 IOCSH_DECL_WRAPPER_IS_INT(unsigned long long);
@@ -106,8 +177,16 @@ IOCSH_DECL_WRAPPER_IS_INT(              bool);
 #undef IOSH_DECL_WRAPPER_IS_INT
 
 template <typename T> struct is_flt;
-template <> struct is_flt<float > { typedef float  type; static const char *name() { return "float" ; } };
-template <> struct is_flt<double> { typedef double type; static const char *name() { return "double"; } };
+template <> struct is_flt<float > {
+	typedef float  type;
+	static const char *name()    { return "float" ;  }
+	static const char *argName() { return "<float>"; }
+};
+template <> struct is_flt<double> {
+	typedef double type;
+	static const char *name()    { return "double" ;  }
+	static const char *argName() { return "<double>"; }
+};
 
 
 template <typename T> struct is_str;
@@ -288,6 +367,74 @@ template <typename T, int USER> struct is_scalr<const T&, const typename is_scal
 	typedef is_scal<T>                        stype;
 };
 
+/*
+ * Classification of argument types. The built-in Convert and ContextSize
+ * implementations are selected by this (integer) kind:
+ * the SFINAE tests above are evaluated once per type and only those
+ * which match its shape (value, pointer or reference) are tried.
+ */
+enum ArgKindValue {
+	KindOther = 0,
+	KindInt,       /* integral type by value                     */
+	KindFlt,       /* float or double by value                   */
+	KindCplx,      /* std::complex by value                      */
+	KindStr,       /* std::string by value or by reference       */
+	KindStrp,      /* pointer to std::string                     */
+	KindScalp,     /* pointer to an integral or float type       */
+	KindScalr      /* reference to an integral or float type     */
+};
+
+template <typename T, typename U = T> struct ValueKind {
+	static const int value = KindOther;
+};
+
+template <typename T> struct ValueKind<T, typename is_int<T>::type> {
+	static const int value = KindInt;
+};
+
+template <typename T> struct ValueKind<T, typename is_flt<T>::type> {
+	static const int value = KindFlt;
+};
+
+template <typename T> struct ValueKind<T, typename is_cplx<T>::type> {
+	static const int value = KindCplx;
+};
+
+template <typename T> struct ValueKind<T, typename is_str<T>::type> {
+	static const int value = KindStr;
+};
+
+/* Kind of T* and T& by the kind of (non-const) T */
+template <typename T> struct PtrKind {
+	static const int value = ( KindInt == ValueKind<T>::value || KindFlt == ValueKind<T>::value ) ? KindScalp
+	                       : ( KindStr == ValueKind<T>::value                                    ) ? KindStrp
+	                       :                                                                         KindOther;
+};
+
+template <typename T> struct PtrKind<const T> : public PtrKind<T> {
+};
+
+template <typename T> struct RefKind {
+	static const int value = ( KindInt == ValueKind<T>::value || KindFlt == ValueKind<T>::value ) ? KindScalr
+	                       : ( KindStr == ValueKind<T>::value                                    ) ? KindStr
+	                       :                                                                         KindOther;
+};
+
+template <typename T> struct RefKind<const T> : public RefKind<T> {
+};
+
+template <typename T> struct ArgKind {
+	static const int value = ValueKind<T>::value;
+};
+
+template <typename T> struct ArgKind<T *> {
+	static const int value = PtrKind<T>::value;
+};
+
+template <typename T> struct ArgKind<T &> {
+	static const int value = RefKind<T>::value;
+};
+
 
 
 /* Work-around for C++89
@@ -310,6 +457,129 @@ template <typename T> struct Reference<T&> {
 	typedef const T &const_type;
 };
 
+/*
+ * Output of a wrapper (result and mutable arguments) is
+ * collected in a PrintBuffer and written to the console
+ * with a single call. The buffer lives on the stack; if it
+ * overflows it is moved to the heap.
+ */
+#ifndef IOCSH_DECL_WRAPPER_PRINT_BUFSZ
+#define IOCSH_DECL_WRAPPER_PRINT_BUFSZ 256
+#endif
+
+class PrintBuffer {
+private:
+	char    buf_[ IOCSH_DECL_WRAPPER_PRINT_BUFSZ ];
+	char   *p_;
+	size_t  cap_;
+	size_t  len_;
+
+	PrintBuffer(const PrintBuffer &);
+	PrintBuffer & operator=(const PrintBuffer &);
+
+	/* make room for 'need' more chars (plus NUL) */
+	bool grow(size_t need)
+	{
+	size_t  ncap = 2*cap_;
+	char   *np;
+		if ( ncap < len_ + need + 1 ) {
+			ncap = len_ + need + 1;
+		}
+		if ( ! (np = (char*) ::malloc( ncap )) ) {
+			return false;
+		}
+		::memcpy( np, p_, len_ + 1 );
+		if ( p_ != buf_ ) {
+			::free( p_ );
+		}
+		p_   = np;
+		cap_ = ncap;
+		return true;
+	}
+
+public:
+	PrintBuffer()
+	: p_  ( buf_          ),
+	  cap_( sizeof(buf_)  ),
+	  len_( 0             )
+	{
+		buf_[0] = 0;
+	}
+
+	/* Append formatted output */
+	void append(const char *fmt, ...)
+	{
+	va_list ap;
+	int     n;
+		va_start( ap, fmt );
+		n = vsnprintf( p_ + len_, cap_ - len_, fmt, ap );
+		va_end( ap );
+		if ( n < 0 ) {
+			p_[len_] = 0;
+			return;
+		}
+		if ( (size_t)n >= cap_ - len_ ) {
+			if ( ! grow( n ) ) {
+				/* keep what fit */
+				len_ = cap_ - 1;
+				return;
+			}
+			va_start( ap, fmt );
+			n = vsnprintf( p_ + len_, cap_ - len_, fmt, ap );
+			va_end( ap );
+		}
+		len_ += n;
+	}
+
+	/* Append 'len' characters verbatim */
+	void write(const char *s, size_t len)
+	{
+		if ( len >= cap_ - len_ && ! grow( len ) ) {
+			len = cap_ - len_ - 1;
+		}
+		::memcpy( p_ + len_, s, len );
+		len_       += len;
+		p_[ len_ ]  = 0;
+	}
+
+	/* Number of characters collected so far */
+	size_t size() const
+	{
+		return len_;
+	}
+
+	/* Everything collected so far (NUL-terminated) */
+	const char *str() const
+	{
+		return p_;
+	}
+
+	/* Discard everything collected so far */
+	void clear()
+	{
+		len_  = 0;
+		p_[0] = 0;
+	}
+
+	/* Write everything collected so far */
+	void flush()
+	{
+		if ( len_ ) {
+			epicsStdoutPrintf( "%s", p_ );
+			len_  = 0;
+			p_[0] = 0;
+		}
+	}
+
+	~PrintBuffer()
+	{
+		flush();
+		if ( p_ != buf_ ) {
+			::free( p_ );
+		}
+	}
+};
+
 /*
  * For the default Printer implementation we
  * use specialized 'format strings'.
@@ -327,7 +597,7 @@ template <typename T, typename R = T, int USER = 0> struct PrintFmts
  */
 #ifndef IOCSH_DECL_WRAPPER_PRINTFMTS_DEBUG
 {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		return 0;
 	}
@@ -339,9 +609,15 @@ template <typename T, typename R = T, int USER = 0> struct PrintFmts
  * Provide partial specializations for basic
  * types; the user may provide a more specific
  * specialization to override the formats...
+ *
+ * Numerical formats that are handled by NumFmt (see below)
+ * are marked by deriving from BuiltinPrintFmts; a user
+ * override of PrintFmts thus disables NumFmt automatically.
  */
+struct BuiltinPrintFmts {};
+
 template <typename T, int USER> struct PrintFmts<T, bool, USER> {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%d", 0 };
 		return r;
@@ -349,39 +625,39 @@ template <typename T, int USER> struct PrintFmts<T, bool, USER> {
 };
 
 template <typename T, int USER> struct PrintFmts<T, char, USER> {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%c", " (0x%02hhx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, short, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, short, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%hi", " (0x%04hx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, int, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, int, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%i", " (0x%08x)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, long, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, long, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%li", " (0x%08lx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, long long, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, long long, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%lli", " (0x%16llx)", 0 };
 		return r;
@@ -389,55 +665,55 @@ template <typename T, int USER> struct PrintFmts<T, long long, USER> {
 };
 
 template <typename T, int USER> struct PrintFmts<T, unsigned char, USER> {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%c", " (0x%02hhx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, unsigned short, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, unsigned short, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%hu", " (0x%04hx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, unsigned int, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, unsigned int, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%u", " (0x%08x)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, unsigned long, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, unsigned long, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%lu", " (0x%08lx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, unsigned long long, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, unsigned long long, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%llu", " (0x%16llx)", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, float, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, float, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%g", 0 };
 		return r;
 	}
 };
 
-template <typename T, int USER> struct PrintFmts<T, double, USER> {
-	static const char **get()
+template <typename T, int USER> struct PrintFmts<T, double, USER> : BuiltinPrintFmts {
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%.10lg", 0 };
 		return r;
@@ -445,7 +721,7 @@ template <typename T, int USER> struct PrintFmts<T, double, USER> {
 };
 
 template <typename T, int USER> struct PrintFmts<T, typename is_chrp<T>::type, USER> {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r [] = { "%p -> ", "%s", 0 };
 		return r;
@@ -453,13 +729,144 @@ template <typename T, int USER> struct PrintFmts<T, typename is_chrp<T>::type, U
 };
 
 template <typename T, int USER> struct PrintFmts<T *, typename is_chrp<T*>::falsetype, USER> {
-	static const char **get()
+	static const char **get() IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		static const char *r[] = { "%p", 0 };
 		return r;
 	}
 };
 
+/*
+ * Fast formatting of numbers; produces the same output as
+ * the built-in PrintFmts without going through the printf
+ * parser. Integers are formatted by hand, floating-point
+ * numbers by std::to_chars (if the library implements it;
+ * otherwise the printf formats are used).
+ *
+ * 'value' selects NumFmt for a type. Specialize (USER=0)
+ * with 'value = false' to use the PrintFmts for a type;
+ * define IOCSH_DECL_WRAPPER_NO_NUMFMT to disable NumFmt
+ * altogether.
+ */
+template <typename T, typename R = T, int USER = 0> struct NumFmt {
+	static const bool value = false;
+};
+
+/* Decimal and zero/blank-padded hex, e.g., "-12 (0xfffffff4)" */
+template <typename S, typename U, unsigned HEXW, char PAD> struct IntFmt {
+	static const bool value = true;
+
+	static void print(PrintBuffer &out, S v) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+	static const char hex[] = "0123456789abcdef";
+	/* decimal digits + sign + " (0x" + hex digits + ")" */
+	char     buf[ 3*sizeof(U) + 1 + 4 + 2*sizeof(U) + HEXW + 1 ];
+	char    *e = buf + sizeof(buf);
+	char    *p = e;
+	U        u = (U)v;
+	unsigned n;
+	bool     neg = (S)-1 < (S)0 && ( u >> (8*sizeof(U) - 1) );
+
+		*--p = ')';
+		n    = 0;
+		do {
+			*--p = hex[ u & 0xf ];
+			u  >>= 4;
+			n++;
+		} while ( u );
+		while ( n++ < HEXW ) {
+			*--p = PAD;
+		}
+		*--p = 'x'; *--p = '0'; *--p = '('; *--p = ' ';
+
+		u = (U)v;
+		if ( neg ) {
+			u = (U)0 - u;
+		}
+		do {
+			*--p = (char)('0' + u % 10);
+			u   /= 10;
+		} while ( u );
+		if ( neg ) {
+			*--p = '-';
+		}
+		out.write( p, e - p );
+	}
+};
+
+#ifndef IOCSH_DECL_WRAPPER_NO_NUMFMT
+template <typename T, int USER> struct NumFmt<T, short,              USER> : IntFmt<short,              unsigned short,      4, '0'> {};
+template <typename T, int USER> struct NumFmt<T, int,                USER> : IntFmt<int,                unsigned int,        8, '0'> {};
+template <typename T, int USER> struct NumFmt<T, long,               USER> : IntFmt<long,               unsigned long,       8, '0'> {};
+template <typename T, int USER> struct NumFmt<T, long long,          USER> : IntFmt<long long,          unsigned long long, 16, ' '> {};
+template <typename T, int USER> struct NumFmt<T, unsigned short,     USER> : IntFmt<unsigned short,     unsigned short,      4, '0'> {};
+template <typename T, int USER> struct NumFmt<T, unsigned int,       USER> : IntFmt<unsigned int,       unsigned int,        8, '0'> {};
+template <typename T, int USER> struct NumFmt<T, unsigned long,      USER> : IntFmt<unsigned long,      unsigned long,       8, '0'> {};
+template <typename T, int USER> struct NumFmt<T, unsigned long long, USER> : IntFmt<unsigned long long, unsigned long long, 16, ' '> {};
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+/* std::to_chars 'general' with precision is specified to match printf("%.<prec>g") */
+template <typename T, int PREC> struct FltFmt {
+	static const bool value = true;
+
+	static void print(PrintBuffer &out, T v) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+	char              buf[64];
+	std::to_chars_result r = std::to_chars( buf, buf + sizeof(buf), (double)v, std::chars_format::general, PREC );
+		if ( r.ec == std::errc() ) {
+			out.write( buf, r.ptr - buf );
+		} else {
+			out.append( "%.*g", PREC, (double)v );
+		}
+	}
+};
+
+template <typename T, int USER> struct NumFmt<T, float,  USER> : FltFmt<float,   6> {};
+template <typename T, int USER> struct NumFmt<T, double, USER> : FltFmt<double, 10> {};
+#endif
+#endif
+
+/* Is F one of the built-in (i.e., not user-overridden) PrintFmts? */
+template <typename F> struct IsBuiltinPrintFmts {
+	typedef char yes;
+	typedef char (&no)[2];
+	static yes test( const BuiltinPrintFmts * );
+	static no  test( ... );
+	static const bool value = sizeof( test( (F*)0 ) ) == sizeof( yes );
+};
+
+/* Print using the PrintFmts formats */
+template <typename T> struct PrintFmtsPrinter {
+	static void print( PrintBuffer &out, typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrintFmts<T>::get() ) )
+	{
+		const char **fmts = PrintFmts<T>::get();
+		if ( ! fmts ) {
+			errlogPrintf("<No print format for this return type implemented>\n");
+		} else {
+			while ( *fmts ) {
+				out.append( *fmts, r );
+				fmts++;
+			}
+			out.append("\n");
+		}
+	}
+};
+
+/* Print using NumFmt */
+template <typename T> struct NumFmtPrinter {
+	static void print( PrintBuffer &out, typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( NumFmt<T>::print( out, r ) ) )
+	{
+		NumFmt<T>::print( out, r );
+		out.write( "\n", 1 );
+	}
+};
+
+template <typename T, bool USE_NUMFMT = NumFmt<T>::value && IsBuiltinPrintFmts< PrintFmts<T> >::value>
+struct DefaultPrinter : PrintFmtsPrinter<T> {};
+
+template <typename T>
+struct DefaultPrinter<T, true> : NumFmtPrinter<T> {};
+
 /*
  * This template can be overridden to handle class T.
  * The template is expanded PrinterBase< sometype, sometype, 0 >
@@ -475,17 +882,13 @@ template <typename T, int USER> struct PrintFmts<T *, typename is_chrp<T*>::fals
  */
 template <typename T, typename R, int USER = 0> class PrinterBase {
 public:
-	static void print( typename Reference<R>::const_type r ) {
-		const char **fmts = PrintFmts<typename skipref<R>::type>::get();
-		if ( ! fmts ) {
-			errlogPrintf("<No print format for this return type implemented>\n");
-		} else {
-			while ( *fmts ) {
-				epicsStdoutPrintf( *fmts, r );
-				fmts++;
-			}
-			epicsStdoutPrintf("\n");
-		}
+	static void print( PrintBuffer &out, typename Reference<R>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( DefaultPrinter<typename skipref<R>::type>::print( out, r ) ) ) {
+		DefaultPrinter<typename skipref<R>::type>::print( out, r );
+	}
+
+	static void print( typename Reference<R>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( print( *(PrintBuffer*)0, r ) ) ) {
+		PrintBuffer out;
+		print( out, r );
 	}
 };
 
@@ -494,18 +897,23 @@ public:
  */
 template<int USER> class PrinterBase<const char *, const char *, USER> {
 public:
-	static void print( typename Reference<const char*>::const_type r ) {
+	static void print( PrintBuffer &out, typename Reference<const char*>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrintFmts<const char *, const char *>::get() ) ) {
 		const char **fmts = PrintFmts<const char *, const char *>::get();
 		if ( ! fmts ) {
 			errlogPrintf("<No print format for this return type implemented>\n");
 		} else {
 			while ( *fmts ) {
-				epicsStdoutPrintf( *fmts, r );
+				out.append( *fmts, r );
 				fmts++;
 			}
-			epicsStdoutPrintf("\n");
+			out.append("\n");
 		}
 	}
+
+	static void print( typename Reference<const char*>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( print( *(PrintBuffer*)0, r ) ) ) {
+		PrintBuffer out;
+		print( out, r );
+	}
 };
 
 /*
@@ -519,9 +927,15 @@ public:
  */
 template <typename T, int USER> class PrinterBase< T, typename is_cplx< T >::type, USER > {
 public:
-	static void print( const std::complex<T> &r )
+	static void print( PrintBuffer &out, const T &r ) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+		out.append("%.10Lg J %.10Lg\n", (long double)r.real(), (long double)r.imag());
+	}
+
+	static void print( const T &r ) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
-		epicsStdoutPrintf("%.10Lg J %.10Lg\n", (long double)r.real(), (long double)r.imag());
+		PrintBuffer out;
+		print( out, r );
 	}
 };
 
@@ -530,37 +944,125 @@ public:
  */
 template <typename T, int USER> class PrinterBase< T, typename is_str<T>::type, USER > {
 public:
-	static void print( typename Reference<T>::const_type r )
+	static void print( PrintBuffer &out, typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrinterBase< const char *, const char *, USER >::print( out, r.c_str() ) ) )
+	{
+		PrinterBase< const char *, const char *, USER >::print( out, r.c_str() );
+	}
+
+	static void print( typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrinterBase< const char *, const char *, USER >::print( r.c_str() ) ) )
 	{
 		PrinterBase< const char *, const char *, USER >::print( r.c_str() );
 	}
 };
 
+#if __cplusplus >= 201703L
+template <int USER> class PrinterBase< std::string_view, std::string_view, USER > {
+public:
+	static void print( PrintBuffer &out, const std::string_view &r ) noexcept
+	{
+		out.append( "%p -> %.*s\n", (void*)r.data(), (int)r.size(), r.data() ? r.data() : "" );
+	}
+
+	static void print( const std::string_view &r ) noexcept
+	{
+		PrintBuffer out;
+		print( out, r );
+	}
+};
+#endif
+
 template <typename T, int USER> class PrinterBase< T, typename is_strp<T>::type, USER > {
 public:
-	static void print( typename Reference<T>::const_type r )
+	static void print( PrintBuffer &out, typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrinterBase< const char *, const char *, USER >::print( out, (const char *)0 ) ) )
+	{
+		PrinterBase< const char *, const char *, USER >::print( out, r ? r->c_str() : 0 );
+	}
+
+	static void print( typename Reference<T>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( PrinterBase< const char *, const char *, USER >::print( (const char *)0 ) ) )
 	{
 		PrinterBase< const char *, const char *, USER >::print( r ? r->c_str() : 0 );
 	}
 };
 
+/*
+ * Does printer 'P' support printing a 'R' into a PrintBuffer,
+ * i.e., does it have a
+ *
+ *   static void print( PrintBuffer &, typename Reference<R>::const_type );
+ *
+ * member? User printers which only implement 'print(r)' are
+ * still supported: the PrintBuffer is flushed before they are
+ * called (so that the ordering of the output is preserved).
+ */
+template <typename P, typename R> struct BufferedPrint {
+	typedef void (*PrintFn)( PrintBuffer &, typename Reference<R>::const_type );
+	typedef char yes;
+	typedef char (&no)[2];
+
+	template <PrintFn> struct Check {};
+
+	template <typename Q> static yes test( Check<&Q::print> * );
+	template <typename Q> static no  test( ... );
+
+	static const bool value = sizeof( test<P>( 0 ) ) == sizeof( yes );
+};
+
+template <typename P, typename R, bool BUFFERED = BufferedPrint<P, R>::value> struct PrintVia {
+	static void print( PrintBuffer &out, typename Reference<R>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( P::print( r ) ) )
+	{
+		out.flush();
+		P::print( r );
+	}
+};
+
+template <typename P, typename R> struct PrintVia<P, R, true> {
+	static void print( PrintBuffer &out, typename Reference<R>::const_type r ) IOCSH_DECL_WRAPPER_NOEXCEPT_IF( noexcept( P::print( out, r ) ) )
+	{
+		P::print( out, r );
+	}
+};
+
+class Context;
+
 class ContextElBase {
+private:
+	/* Context keeps its elements in a singly linked list */
+	ContextElBase *next_;
 public:
+	ContextElBase()
+	: next_( 0 )
+	{
+	}
+
 	virtual bool isConst() const = 0;
 	virtual void print()     {}
+	/* Print into a PrintBuffer; the default flushes and falls back to 'print()' */
+	virtual void print(PrintBuffer &out)
+	{
+		out.flush();
+		print();
+	}
 	virtual ~ContextElBase() {}
+
+	friend class Context;
 };
 
-/* 'Reference holder' for abitrary simple objects. Similar to
- * a (very dumb) smart pointer but without having to worry about
- * C++11 or boost.
+/* 'Reference holder' for abitrary simple objects. The object
+ * is embedded in the element which itself lives in the Context's
+ * arena (or on the heap if the arena is exhausted).
  */
 template <typename T, typename I> class ContextEl : public ContextElBase {
 protected:
-	T *p_;
+	T obj_;
 	ContextEl(I inival)
+	: obj_( inival )
+	{
+	}
+
+	/* Extra space needed (beyond sizeof(ContextEl)) to hold 'inival' */
+	static size_t extra(I inival)
 	{
-		p_ = new T( inival );
+		return 0;
 	}
 public:
 
@@ -571,7 +1073,7 @@ public:
 
 	T * p()
 	{
-		return p_;
+		return &obj_;
 	}
 
 	virtual void print()
@@ -579,23 +1081,33 @@ public:
 		PrinterBase<T, T, 0>::print( *p() );
 	}
 
+	virtual void print(PrintBuffer &out)
+	{
+		PrintVia< PrinterBase<T, T, 0>, T >::print( out, *p() );
+	}
+
 	virtual ~ContextEl()
 	{
-		delete p_;
 	}
 
 	friend class Context;
 };
 
 /*
- * Specialization for C-strings
+ * Specialization for C-strings; the copy of the string
+ * is stored immediately after the element.
  */
 template <> class ContextEl<char[], const char *>: public ContextElBase {
 protected:
 	char *p_;
 	ContextEl(const char *inival)
 	{
-		p_ = inival ? epicsStrDup( inival ) : 0;
+		p_ = inival ? ::strcpy( reinterpret_cast<char*>( this + 1 ), inival ) : 0;
+	}
+
+	static size_t extra(const char *inival)
+	{
+		return inival ? ::strlen( inival ) + 1 : 0;
 	}
 public:
 
@@ -616,89 +1128,333 @@ public:
 		PrinterBase< const char *, const char *, 0 >::print( p_ );
 	}
 
+	virtual void print(PrintBuffer &out)
+	{
+		PrintVia< PrinterBase< const char *, const char *, 0 >, const char * >::print( out, p_ );
+	}
+
 
 	virtual ~ContextEl()
 	{
-		::free( p_ );
 	}
 
 	friend class Context;
 };
 
 /*
- * Context holds the object pointers until the Context is
- * destroyed. Its destructor eventually delets all objects
- * held by the Context.
+ * Alignment of objects allocated from the Context's arena.
  */
-class Context : public std::vector<ContextElBase*> {
-private:
-	const iocshArgBuf *args_;
-	std::vector<int>   mutableArgIdx_;
+union ContextAlign {
+	long double  ld;
+	long long    ll;
+	double       d;
+	void        *p;
+	void       (*f)();
+};
+
+template <size_t SZ> struct ContextRound {
+	static const size_t value = (SZ + sizeof(ContextAlign) - 1)/sizeof(ContextAlign)*sizeof(ContextAlign);
+};
 
+class ConversionError : public std::runtime_error {
 public:
-	Context(const iocshArgBuf *args, unsigned numArgs)
-	: args_         ( args        ),
-	  mutableArgIdx_( numArgs, -1 )
+	ConversionError( const std::string & msg )
+	: runtime_error( msg )
 	{
 	}
 
-	virtual unsigned getNumArgs() const
+	ConversionError( const char * msg )
+	: runtime_error( std::string( msg ) )
 	{
-		return mutableArgIdx_.size();
 	}
+};
 
-	virtual ContextElBase * getArg(unsigned idx) const
+/*
+ * Context holds the objects until the Context is destroyed.
+ * Objects are placement-constructed into an arena that is
+ * provided by the derived 'InlineContext' (which normally lives
+ * on the stack of the wrapper). Only if the arena is exhausted
+ * objects are allocated from the heap.
+ * Its destructor eventually destroys all objects held by the
+ * Context (in reverse order of creation).
+ */
+class Context {
+private:
+	const iocshArgBuf  *args_;
+	PrintBuffer        *out_;
+	ContextElBase      *els_;
+	ContextElBase     **argEls_;
+	unsigned            numArgs_;
+	char               *arena_;
+	size_t              arenaSize_;
+	size_t              arenaUsed_;
+	const char         *error_;
+
+	Context(const Context &);
+	Context & operator=(const Context &);
+
+	static size_t round(size_t sz)
 	{
-	int argIdx;
-
-		if ( idx >= getNumArgs() || (argIdx = mutableArgIdx_[idx]) < 0 )
-			return 0;
-		return (*this)[argIdx];
+		return (sz + sizeof(ContextAlign) - 1)/sizeof(ContextAlign)*sizeof(ContextAlign);
 	}
 
-	virtual ~Context()
+	bool inArena(const void *p) const
 	{
-	iterator it;
+		return (const char*)p >= arena_ && (const char*)p < arena_ + arenaSize_;
+	}
 
-		for ( it = begin(); it != end(); ++it ) {
-			delete *it;
+	/* Returns NULL if the arena is exhausted */
+	void *allocate(size_t sz)
+	{
+		sz = round( sz );
+		if ( arenaSize_ - arenaUsed_ >= sz ) {
+			void *rval  = arena_ + arenaUsed_;
+			arenaUsed_ += sz;
+			return rval;
 		}
+		return 0;
 	}
 
-	const iocshArgBuf *getArgBuf()
+protected:
+	Context(const iocshArgBuf *args, PrintBuffer *out, unsigned numArgs, ContextElBase **argEls, char *arena, size_t arenaSize)
+	: args_      ( args      ),
+	  out_       ( out       ),
+	  els_       ( 0         ),
+	  argEls_    ( argEls    ),
+	  numArgs_   ( numArgs   ),
+	  arena_     ( arena     ),
+	  arenaSize_ ( arenaSize ),
+	  arenaUsed_ ( 0         ),
+	  error_     ( 0         )
 	{
-		return args_;
 	}
 
-	/*
-	 * Create a new object of type T and attach to
-	 * the Context.
-	 * RETURNS: pointer to the new object.
-	 */
-	template <typename T, typename I> T * make(I i, int recordIdx = -1)
+	/* Destroy all elements (most recent first) */
+	void clear()
 	{
-		ContextEl<T,I> *el = new ContextEl<T,I>( i );
-		if ( recordIdx >= 0 && (unsigned)recordIdx < mutableArgIdx_.size() ) {
-			mutableArgIdx_[ recordIdx ] = size();
+	ContextElBase *el;
+
+		while ( (el = els_) ) {
+			els_ = el->next_;
+			el->~ContextElBase();
+			if ( ! inArena( el ) ) {
+				::operator delete( el );
+			}
 		}
-		push_back(el);
-		return el->p();
 	}
-};
 
-class ConversionError : public std::runtime_error {
 public:
-	ConversionError( const std::string & msg )
-	: runtime_error( msg )
+	virtual unsigned getNumArgs() const
 	{
+		return numArgs_;
 	}
 
-	ConversionError( const char * msg )
-	: runtime_error( std::string( msg ) )
+	virtual ContextElBase * getArg(unsigned idx) const
+	{
+		if ( idx >= getNumArgs() )
+			return 0;
+		return argEls_[idx];
+	}
+
+	virtual ~Context()
+	{
+		clear();
+	}
+
+	const iocshArgBuf *getArgBuf()
+	{
+		return args_;
+	}
+
+	/* Buffer collecting the output of the wrapper (may be NULL) */
+	PrintBuffer *getPrintBuffer()
+	{
+		return out_;
+	}
+
+	/*
+	 * Report a conversion failure from Convert::getArg without throwing
+	 * ConversionError. getArg must still return a value of its type
+	 * (which is discarded); the user function is not called and
+	 * 'msg' (which must have static storage duration, e.g., a string
+	 * literal) is reported like a ConversionError.
+	 * The first failure is reported. C++98: throws ConversionError.
+	 */
+	void fail(const char *msg) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+#if __cplusplus >= 201103L
+		if ( ! error_ ) {
+			error_ = msg;
+		}
+#else
+		throw ConversionError( msg );
+#endif
+	}
+
+	/* Message of the first failure reported by 'fail()' (NULL if none) */
+	const char *getError() const
+	{
+		return error_;
+	}
+
+	/*
+	 * Create a new object of type T and attach to
+	 * the Context.
+	 * RETURNS: pointer to the new object.
+	 */
+	template <typename T, typename I> T * make(I i, int recordIdx = -1)
+	{
+	size_t          sz = sizeof( ContextEl<T,I> ) + ContextEl<T,I>::extra( i );
+	void           *m  = allocate( sz );
+	ContextEl<T,I> *el;
+
+		if ( m ) {
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			try {
+				el = new ( m ) ContextEl<T,I>( i );
+			} catch ( ... ) {
+				/* the chunk was the last one allocated */
+				arenaUsed_ -= round( sz );
+				throw;
+			}
+#else
+			el = new ( m ) ContextEl<T,I>( i );
+#endif
+		} else {
+			m = ::operator new( sz );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			try {
+				el = new ( m ) ContextEl<T,I>( i );
+			} catch ( ... ) {
+				::operator delete( m );
+				throw;
+			}
+#else
+			el = new ( m ) ContextEl<T,I>( i );
+#endif
+		}
+		el->next_ = els_;
+		els_      = el;
+		if ( recordIdx >= 0 && (unsigned)recordIdx < numArgs_ ) {
+			argEls_[ recordIdx ] = el;
+		}
+		return el->p();
+	}
+};
+
+/*
+ * Context with inline storage for the mutable-argument table
+ * of 'N' arguments and an arena of 'SZ' bytes.
+ */
+template <unsigned N, size_t SZ> class InlineContext : public Context {
+private:
+	ContextElBase *argEls_[ N > 0 ? N : 1 ];
+	union {
+		ContextAlign align_;
+		char         buf_[ SZ > 0 ? SZ : 1 ];
+	}              arena_;
+
+public:
+	InlineContext(const iocshArgBuf *args, PrintBuffer *out = 0)
+	: Context( args, out, N, argEls_, arena_.buf_, SZ )
+	{
+		for ( unsigned i = 0; i < N; i++ ) {
+			argEls_[i] = 0;
+		}
+	}
+
+	virtual ~InlineContext()
 	{
+		clear();
 	}
 };
 
+/*
+ * Arena space (in bytes) that Convert<T>::getArg() needs
+ * in the Context. This is used to size the InlineContext
+ * of a wrapper at compile time. If a user-defined Convert
+ * creates objects that don't fit then the context falls
+ * back to the heap; the user may specialize this template
+ * (analogous to Convert) to avoid this.
+ * The default assumes a 'typical' object.
+ */
+#ifndef IOCSH_DECL_WRAPPER_CSTR_RESERVE
+/* space reserved for copies of mutable C-strings */
+#define IOCSH_DECL_WRAPPER_CSTR_RESERVE 64
+#endif
+
+/* Built-in sizes by ArgKind */
+template <typename T, int KIND> struct ContextSizeKind {
+	static const size_t value = ContextRound< sizeof( ContextEl<std::string, const char *> ) >::value;
+};
+
+template <typename T> struct ContextSizeKind<T, KindInt> {
+	static const size_t value = 0;
+};
+
+template <typename T> struct ContextSizeKind<T, KindFlt> {
+	static const size_t value = 0;
+};
+
+template <typename T> struct ContextSizeKind<T, KindCplx> {
+	static const size_t value = 0;
+};
+
+template <typename T> struct ContextSizeKind<T*, KindScalp> {
+	static const size_t value = ContextRound< sizeof( ContextEl<T, typename is_scalp<T*>::stype::iocsh_c_type> ) >::value;
+};
+
+template <typename T> struct ContextSizeKind<T&, KindScalr> {
+	static const size_t value = ContextRound< sizeof( ContextEl<T, typename is_scalr<T&>::stype::iocsh_c_type> ) >::value;
+};
+
+template <typename T, typename R = T, int USER = 0> struct ContextSize : public ContextSizeKind<T, ArgKind<T>::value> {
+};
+
+template <int USER> struct ContextSize<void, void, USER> {
+	static const size_t value = 0;
+};
+
+template <int USER> struct ContextSize<std::string, std::string, USER> {
+	static const size_t value = 0;
+};
+
+template <int USER> struct ContextSize<std::pair<const char *, size_t>, std::pair<const char *, size_t>, USER> {
+	static const size_t value = 0;
+};
+
+#if __cplusplus >= 201703L
+template <int USER> struct ContextSize<std::string_view, std::string_view, USER> {
+	static const size_t value = 0;
+};
+#endif
+
+template <int USER> struct ContextSize<const char *, const char *, USER> {
+	static const size_t value = 0;
+};
+
+template <int USER> struct ContextSize<char *, char *, USER> {
+	static const size_t value = ContextRound< sizeof( ContextEl<char[], const char *> ) + IOCSH_DECL_WRAPPER_CSTR_RESERVE >::value;
+};
+
+
+/*
+ * Built-in converters whose getArg() extracts the argument directly
+ * from the iocshArgBuf, i.e., without using the Context, are marked
+ * by deriving from DirectConvert; a user override of Convert is
+ * thus never taken for direct.
+ */
+struct DirectConvert {};
+
+/* Is C a converter marked by DirectConvert? */
+template <typename C> struct IsDirectConvert {
+	typedef char yes;
+	typedef char (&no)[2];
+	static yes test( const DirectConvert * );
+	static no  test( ... );
+	static const bool value = sizeof( test( (C*)0 ) ) == sizeof( yes );
+};
+
 /*
  * Default implementation
  */
@@ -708,21 +1464,37 @@ public:
 	 * Print arguments recorded in the context. These
 	 * are mutable arguments that can be modified by
 	 * the user function.
+	 *
+	 * This never throws (see NoThrowPrint): an exception raised
+	 * while printing an argument is reported in place of its value.
 	 */
-	static void printArgs(Context *ctx)
+	static void printArgs(Context *ctx) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
-	bool     headerPrinted = false;
-	unsigned i;
-	unsigned nargs         = ctx->getNumArgs();
+	bool         headerPrinted = false;
+	unsigned     i;
+	unsigned     nargs         = ctx->getNumArgs();
+	PrintBuffer  local;
+	PrintBuffer *out           = ctx->getPrintBuffer() ? ctx->getPrintBuffer() : &local;
 
 		for ( i = 0; i < nargs; i++ ) {
 			ContextElBase *el = ctx->getArg( i );
 			if ( el && ! el->isConst() ) {
 				if ( ! headerPrinted ) {
-					epicsStdoutPrintf("Mutable arguments after execution:\n");
+					out->append("Mutable arguments after execution:\n");
 					headerPrinted = true;
 				}
-				epicsStdoutPrintf("arg[%i]: ", i); el->print();
+				out->append("arg[%i]: ", i);
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+				try {
+					el->print( *out );
+				} catch ( std::exception &e ) {
+					out->append( "Error: Exception -- %s\n", e.what() );
+				} catch ( ... ) {
+					out->append( "Error: Unknown Exception\n" );
+				}
+#else
+				el->print( *out );
+#endif
 			}
 		}
 	}
@@ -745,6 +1517,9 @@ public:
  *    }
  */
 template <typename R, typename SIG, SIG *sig, int USER = 0> class Printer    : public PrinterBase<R, R> {
+public:
+	/* Identifies the primary template (see SharedPrinter) */
+	typedef Printer Primary;
 };
 
 template <typename SIG, SIG *sig, int USER = 0> class ArgPrinter : public ArgPrinterBase {
@@ -752,10 +1527,49 @@ template <typename SIG, SIG *sig, int USER = 0> class ArgPrinter : public ArgPri
 
 typedef void (*ArgPrinterType)(Context*);
 
+template <typename A, typename B> struct SameType {
+	static const bool value = false;
+};
+
+template <typename A> struct SameType<A, A> {
+	static const bool value = true;
+};
+
+template <typename P> struct HasPrimary {
+	typedef char yes;
+	typedef char (&no)[2];
+
+	template <typename Q> static yes test( typename Q::Primary * );
+	template <typename Q> static no  test( ... );
+
+	static const bool value = sizeof( test<P>( 0 ) ) == sizeof( yes );
+};
+
+template <typename P, bool HAS = HasPrimary<P>::value> struct IsPrimaryPrinter {
+	static const bool value = false;
+};
+
+template <typename P> struct IsPrimaryPrinter<P, true> {
+	static const bool value = SameType<typename P::Primary, P>::value;
+};
+
+/*
+ * A Printer which has not been specialized for a user function
+ * prints like PrinterBase<R, R>; use the latter so that all user
+ * functions returning 'R' share a single instantiation.
+ */
+template <typename P, typename R, bool PRIMARY = IsPrimaryPrinter<P>::value> struct SharedPrinter {
+	typedef P type;
+};
+
+template <typename P, typename R> struct SharedPrinter<P, R, true> {
+	typedef PrinterBase<R, R> type;
+};
+
 /*
- * Converter to map between user function arguments and iocshArg/iocshArgBuf
+ * Built-in converters, selected by ArgKind (see Convert)
  */
-template <typename T, typename R = T, int USER=0> struct Convert
+template <typename T, typename R, int KIND> struct ConvertKind
 {
 	/*
 	 * Set argument type and default name in iocshArg for type 'T'.
@@ -765,27 +1579,45 @@ template <typename T, typename R = T, int USER=0> struct Convert
 	 * Retrieve argument from iocshArgBuf and convert into
 	 * target type 'R'. May allocate objects in 'Context'.
 	 *
-	 * May throw 'ConversionError'.
+	 * Failures are reported by 'Context::fail()' or by
+	 * throwing 'ConversionError'.
 	 */
 	static R    getArg(const iocshArgBuf *, Context *, int argNo);
 };
 
 /*
- * Allocate a new iocshArg struct and call
+ * Converter to map between user function arguments and iocshArg/iocshArgBuf;
+ * the built-in implementations are provided by ConvertKind. Users add
+ * (or override) conversions by specializing Convert for USER = 0.
+ */
+template <typename T, typename R = T, int USER=0> struct Convert : public ConvertKind<T, R, ArgKind<T>::value>
+{
+};
+
+/*
+ * Arguments whose converter does not use the Context (which may be
+ * NULL). If all arguments of a user function are 'direct' then the
+ * wrapper skips creating a Context and printing mutable arguments.
+ */
+template <typename T, typename R = T, int USER = 0> struct DirectArg {
+	static const bool value = IsDirectConvert< Convert<T> >::value;
+};
+
+/*
+ * Initialize a iocshArg struct and call
  * Convert::setArg() for type 'T'
  */
 template <typename T>
-iocshArg *makeArg(const char *aname = 0)
+iocshArg *makeArg(iocshArg *a, const char *aname = 0)
 {
-	iocshArg *rval = new iocshArg;
-	::memset( rval, 0, sizeof( *rval ) );
+	::memset( a, 0, sizeof( *a ) );
 
-	rval->name = 0;
-	Convert<T>::setArg( rval );
+	a->name = 0;
+	Convert<T>::setArg( a );
 	if ( aname ) {
-		rval->name = aname;
+		a->name = aname;
 	}
-	return rval;
+	return a;
 }
 
 /*
@@ -793,6 +1625,10 @@ iocshArg *makeArg(const char *aname = 0)
  * and strings.
  */
 
+/*
+ * Helper for building names at run-time (the default names of the
+ * built-in converters are compile-time literals; see is_int/is_flt).
+ */
 template <int USER> struct ArgName {
 	static const char *make(const char *fmt, ...)
 	{
@@ -818,21 +1654,17 @@ template <int USER> struct ArgName {
 };
 
 /* Specialization for all integral types */
-template <typename T, int USER> struct Convert<T, typename is_int<T>::type, USER> {
+template <typename T, typename R> struct ConvertKind<T, R, KindInt> : DirectConvert {
 
 	typedef typename is_int<T>::type type;
 
 	static void setArg(iocshArg *a)
 	{
-	static const char *n = 0;
-		if ( !n ) {
-			n = ArgName<0>::make( "<%s>", is_int<T>::name() );
-		}
-		a->name = n ? n : "";
+		a->name = is_int<T>::argName();
 		a->type = iocshArgInt;
 	}
 
-	static type getArg(const iocshArgBuf *arg, Context *ctx, int argNo)
+	static type getArg(const iocshArgBuf *arg, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		return (type)arg->ival;
 	}
@@ -845,7 +1677,7 @@ static void setArgStr(iocshArg *a)
 }
 
 /* Specialization for strings and string reference */
-template <typename T, int USER> struct Convert<T, typename is_str<T>::type, USER> {
+template <typename T, typename R> struct ConvertKind<T, R, KindStr> {
 
 	typedef typename is_str<T>::type type;
 
@@ -862,8 +1694,77 @@ template <typename T, int USER> struct Convert<T, typename is_str<T>::type, USER
 	}
 };
 
+/*
+ * Strings passed by value are constructed directly (no copy is
+ * held in the Context - it could not be modified by the user
+ * function anyways).
+ */
+template <int USER> struct Convert<std::string, std::string, USER> : DirectConvert {
+
+	static void setArg(iocshArg *a)
+	{
+		setArgStr( a );
+	}
+
+	static std::string getArg(const iocshArgBuf *a, Context *ctx, int argNo)
+	{
+		return std::string( a->sval ? a->sval : "" );
+	}
+};
+
+#if __cplusplus >= 201103L
+/* Specialization for rvalue references; the string is moved out of the Context */
+template <int USER> struct Convert<std::string &&, std::string &&, USER> {
+
+	static void setArg(iocshArg *a)
+	{
+		setArgStr( a );
+	}
+
+	static std::string && getArg(const iocshArgBuf *a, Context *ctx, int argNo)
+	{
+		return std::move( * ctx->make<std::string, const char *>( a->sval ? a->sval : "" ) );
+	}
+};
+#endif
+
+#if __cplusplus >= 201703L
+/* Specialization for std::string_view; refers to the iocshArgBuf (no copy) */
+template <int USER> struct Convert<std::string_view, std::string_view, USER> : DirectConvert {
+
+	static void setArg(iocshArg *a)
+	{
+		setArgStr( a );
+	}
+
+	static std::string_view getArg(const iocshArgBuf *a, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+		return a->sval ? std::string_view( a->sval ) : std::string_view();
+	}
+};
+#endif
+
+/*
+ * Specialization for a (pointer, length) pair; refers to
+ * the iocshArgBuf (no copy).
+ */
+template <int USER> struct Convert<std::pair<const char *, size_t>, std::pair<const char *, size_t>, USER> : DirectConvert {
+
+	typedef std::pair<const char *, size_t> type;
+
+	static void setArg(iocshArg *a)
+	{
+		setArgStr( a );
+	}
+
+	static type getArg(const iocshArgBuf *a, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+		return type( a->sval, a->sval ? ::strlen( a->sval ) : 0 );
+	}
+};
+
 /* Specialization for string pointer */
-template <typename T, int USER> struct Convert<T, typename is_strp<T>::type, USER> {
+template <typename T, typename R> struct ConvertKind<T, R, KindStrp> {
 
 	typedef typename is_strp<T>::type type;
 
@@ -888,7 +1789,7 @@ template <int USER> struct Convert<const char *, const char *, USER> {
 		setArgStr( a );
 	}
 
-	static const char * getArg(const iocshArgBuf *a, Context *ctx, int argNo)
+	static const char * getArg(const iocshArgBuf *a, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		return a->sval;
 	}
@@ -910,20 +1811,16 @@ template <int USER> struct Convert<char *, char *, USER> {
 };
 
 /* Specialization for floats */
-template <typename T, int USER> struct Convert<T, typename is_flt<T>::type, USER> {
+template <typename T, typename R> struct ConvertKind<T, R, KindFlt> : DirectConvert {
 	typedef typename is_flt<T>::type type;
 
 	static void setArg(iocshArg *a)
 	{
-	static const char *n = 0;
-		if ( !n ) {
-			n = ArgName<0>::make("<%s>", is_flt<T>::name());
-		}
-		a->name = n ? n : "";
+		a->name = is_flt<T>::argName();
 		a->type = iocshArgDouble;
 	}
 
-	static type getArg(const iocshArgBuf *a, Context *ctx, int argNo)
+	static type getArg(const iocshArgBuf *a, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		return (type) a->dval;
 	}
@@ -932,7 +1829,7 @@ template <typename T, int USER> struct Convert<T, typename is_flt<T>::type, USER
 /*
  * Specialization to pointers to ints and doubles
  */
-template <typename T, int USER> struct Convert<T*, typename is_scalp<T*>::ptype, USER> {
+template <typename T, typename R> struct ConvertKind<T*, R, KindScalp> {
 
 	typedef is_scalp<T*> scalp;
 
@@ -952,7 +1849,7 @@ template <typename T, int USER> struct Convert<T*, typename is_scalp<T*>::ptype,
 /*
  * Specialization to references to ints and doubles
  */
-template <typename T, int USER> struct Convert<T&, typename is_scalr<T&>::rtype, USER> {
+template <typename T, typename R> struct ConvertKind<T&, R, KindScalr> {
 
 	typedef is_scalr<T&> scalr;
 
@@ -971,7 +1868,7 @@ template <typename T, int USER> struct Convert<T&, typename is_scalr<T&>::rtype,
 
 
 /* Specialization for std::complex */
-template <typename T, int USER> struct Convert<T, typename is_cplx<T>::type, USER> {
+template <typename T, typename R> struct ConvertKind<T, R, KindCplx> {
 	typedef typename is_cplx<T>::type type;
 
 	static void setArg(iocshArg *a)
@@ -980,11 +1877,12 @@ template <typename T, int USER> struct Convert<T, typename is_cplx<T>::type, USE
 		a->type = iocshArgString;
 	}
 
-	static type getArg(const iocshArgBuf *a, Context *ctx, int argNo)
+	static type getArg(const iocshArgBuf *a, Context *ctx, int argNo) IOCSH_DECL_WRAPPER_NOEXCEPT
 	{
 		typename type::value_type r, i;
 		if ( ! a->sval || 2 != sscanf( a->sval, is_cplx<T>::fmt(), &r, &i ) ) {
-			throw ConversionError("unable to scan argument into '%g j %g' format");
+			ctx->fail( "unable to scan argument into '%g j %g' format" );
+			return type();
 		}
 		return type( r, i );
 	}
@@ -1004,20 +1902,22 @@ template <typename T, int USER> struct Convert<T, typename is_cplx<T>::type, USE
 template <typename R, bool PRINT=true> class EvalResult {
 public:
 	/* Printer function */
-	typedef void (*PrinterType) (typename Reference<R>::const_type);
+	typedef void (*PrinterType) (PrintBuffer &, typename Reference<R>::const_type);
 private:
-	PrinterType pri;
+	PrinterType  pri;
+	PrintBuffer *out;
 public:
-	EvalResult(PrinterType pri)
-	: pri( pri )
+	EvalResult(PrinterType pri, PrintBuffer *out)
+	: pri( pri ),
+	  out( out )
 	{
 	}
 
 	/* Our ',' operator applies the printer function */
 	void operator,(typename Reference<R>::const_type result)
 	{
-		if ( PRINT ) {
-			pri( result );
+		if ( PRINT && pri ) {
+			pri( *out, result );
 		}
 	}
 };
@@ -1032,7 +1932,7 @@ public:
 	/* Printer function */
 	typedef void *PrinterType;
 
-	EvalResult(PrinterType pri)
+	EvalResult(PrinterType pri, PrintBuffer *out)
 	{
 	}
 
@@ -1047,7 +1947,7 @@ template <typename R, typename SIG> struct Guesser {
 
 	template <SIG *sig> static PrinterType getPrinter()
 	{
-		return Printer<R, SIG, sig>::print;
+		return PrintVia< typename SharedPrinter< Printer<R, SIG, sig>, R >::type, R >::print;
 	}
 
 	template <SIG *sig> static ArgPrinterType getArgPrinter()
@@ -1076,118 +1976,3178 @@ template <typename SIG> struct Guesser<void, SIG> {
 
 
 /*
- * Helper class for building a iocshFuncDef
+ * Count heap allocations made by this library (ArgCache, registries)
+ * for the startup profile (see RegProbe).
  */
-class FuncDef {
-private:
-	iocshFuncDef *def;
-	iocshArg    **args;
+template <int USER = 0> struct AllocCount {
+	static size_t allocs;
+	static size_t bytes;
+
+	static void add(size_t nbytes)
+	{
+		epicsAtomicIncrSizeT( &allocs );
+		epicsAtomicAddSizeT( &bytes, nbytes );
+	}
+};
 
-	FuncDef(const FuncDef&);
-	FuncDef &operator=(const FuncDef&);
+template <int USER> size_t AllocCount<USER>::allocs = 0;
+template <int USER> size_t AllocCount<USER>::bytes  = 0;
 
+/*
+ * Intern table of iocshArg descriptors. All wrapped functions
+ * share one iocshArg per distinct (type, name) pair; names are
+ * deduplicated by their contents. The descriptors are never
+ * released (iocsh keeps pointers to them).
+ */
+class ArgCache {
 public:
-	FuncDef(const char *fname, int nargs)
+	struct Stats {
+		unsigned long lookups;     /* descriptors requested             */
+		unsigned long descriptors; /* distinct descriptors created      */
+		unsigned long bytesSaved;  /* vs. one iocshArg + name copy each */
+	};
+
+private:
+	struct Node {
+		iocshArg      arg;
+		unsigned long hash;
+	};
+
+	/* nodes are allocated in chunks */
+	static const unsigned CHUNK = 64;
+
+	epicsMutexId  mtx_;
+	Node        **tbl_;
+	unsigned long cap_;
+	Node         *chunk_;
+	unsigned      chunkUsed_;
+	Stats         stats_;
+
+	ArgCache()
+	: mtx_      ( epicsMutexMustCreate() ),
+	  tbl_      ( 0     ),
+	  cap_      ( 0     ),
+	  chunk_    ( 0     ),
+	  chunkUsed_( CHUNK )
 	{
-		def         = new iocshFuncDef;
-		::memset(def, 0, sizeof(*def));
-		def->name   = epicsStrDup( fname );
-		def->nargs  = nargs;
-	        args        = new iocshArg*[def->nargs];
-		def->arg    = args;
+	static const iocshFuncDef reportDef = { "iocshWrapArgCache", 0, 0 };
 
-		for ( int i = 0; i < def->nargs; i++ ) {
-			args[i] = 0;
-		}
+		stats_.lookups     = 0;
+		stats_.descriptors = 0;
+		stats_.bytesSaved  = 0;
+		iocshRegister( &reportDef, reportCmd );
 	}
 
-	void setArg(int i, iocshArg *p)
+	static void reportCmd(const iocshArgBuf *)
 	{
-		if ( i >= 0 && i < def->nargs ) {
-			args[i] = p;
-		}
+		report();
 	}
 
-	int getNargs()
+	ArgCache(const ArgCache &);
+	ArgCache & operator=(const ArgCache &);
+
+	static unsigned long hash(const iocshArg *a)
 	{
-		return def ? def->nargs : 0;
+	/* FNV-1a */
+	unsigned long h = 2166136261UL ^ (unsigned long)a->type;
+	const char   *p;
+		for ( p = a->name; *p; p++ ) {
+			h = (h ^ (unsigned char)*p) * 16777619UL;
+		}
+		return h;
 	}
 
-	iocshFuncDef *release()
+	/* 'Open addressing'; keep load factor below 1/2 */
+	void grow()
 	{
-		iocshFuncDef *rval = def;
-		def = 0;
-		return rval;
+	unsigned long   ncap = cap_ ? 2*cap_ : 256;
+	Node          **ntbl = new Node*[ ncap ];
+	AllocCount<>::add( ncap * sizeof( *ntbl ) );
+	unsigned long   i, j;
+
+		for ( i = 0; i < ncap; i++ ) {
+			ntbl[i] = 0;
+		}
+		for ( i = 0; i < cap_; i++ ) {
+			if ( tbl_[i] ) {
+				for ( j = tbl_[i]->hash & (ncap - 1); ntbl[j]; j = (j + 1) & (ncap - 1) )
+					;
+				ntbl[j] = tbl_[i];
+			}
+		}
+		delete [] tbl_;
+		tbl_ = ntbl;
+		cap_ = ncap;
 	}
 
+	Node *newNode()
+	{
+		if ( CHUNK == chunkUsed_ ) {
+			chunk_     = new Node[ CHUNK ];
+			AllocCount<>::add( CHUNK * sizeof( *chunk_ ) );
+			chunkUsed_ = 0;
+		}
+		return &chunk_[ chunkUsed_++ ];
+	}
 
-	~FuncDef()
+	const iocshArg *lookup(const iocshArg *a)
 	{
-		if ( def ) {
-			for ( int i = 0; i < def->nargs; i++ ) {
-				if ( args[i] ) {
-					// should delete args[i]->name but we don't know if that has been strduped yet
-					delete args[i];
-				}
+	iocshArg      key = *a;
+	unsigned long h, i;
+	Node         *n;
+
+		if ( ! key.name ) {
+			key.name = "";
+		}
+		h = hash( &key );
+
+		stats_.lookups++;
+
+		if ( 2*(stats_.descriptors + 1) > cap_ ) {
+			grow();
+		}
+		for ( i = h & (cap_ - 1); (n = tbl_[i]); i = (i + 1) & (cap_ - 1) ) {
+			if ( n->hash == h && n->arg.type == key.type && 0 == ::strcmp( n->arg.name, key.name ) ) {
+				stats_.bytesSaved += sizeof( iocshArg ) + ::strlen( key.name ) + 1;
+				return &n->arg;
 			}
-			delete [] args;
-			delete def->name;
-			delete def;
 		}
+		n        = newNode();
+		n->arg   = key;
+		n->hash  = h;
+		tbl_[i]  = n;
+		stats_.descriptors++;
+		return &n->arg;
 	}
-};
-
-};
 
-#if __cplusplus >= 201103L
+	static ArgCache *get()
+	{
+	static ArgCache theCache;
+		return &theCache;
+	}
 
-#include <initializer_list>
+public:
+	/*
+	 * Return the shared descriptor for (a->type, a->name);
+	 * '*a' itself may be a temporary.
+	 */
+	static const iocshArg *intern(const iocshArg *a)
+	{
+	ArgCache       *c = get();
+	const iocshArg *rval;
+		epicsMutexMustLock( c->mtx_ );
+		rval = c->lookup( a );
+		epicsMutexUnlock( c->mtx_ );
+		return rval;
+	}
 
-namespace IocshDeclWrapper {
+	static Stats getStats()
+	{
+	ArgCache *c = get();
+	Stats     rval;
+		epicsMutexMustLock( c->mtx_ );
+		rval = c->stats_;
+		epicsMutexUnlock( c->mtx_ );
+		return rval;
+	}
 
-/* A special trick to let the user specify overloaded functions. We want to do this
- * with a final macro:
- *   #define _WRAP( fun, overload_args, name, help... )
- * Because the pre-processor requires parentheses around anything containing commas
- * the macro must be expanded like this:
- *
- *   _WRAP( myFunc, (int, char*), "myFunc_1" )
- *
- * The following templates allow us to get rid of the parentheses and use the type
- * signatures...
- */
-template <typename T> struct DropBraces;
+	static void report()
+	{
+	Stats st = getStats();
+		epicsStdoutPrintf("iocshArg descriptors requested: %lu\n", st.lookups);
+		epicsStdoutPrintf("iocshArg descriptors created:   %lu\n", st.descriptors);
+		epicsStdoutPrintf("iocshArg descriptors shared:    %lu\n", st.lookups - st.descriptors);
+		epicsStdoutPrintf("bytes saved:                    %lu\n", st.bytesSaved);
+	}
+};
 
-/* First the specialization for T=void which auto-derives the types; this is used
- * when a function is not overloaded
+/*
+ * Startup profile: cost of registering a wrapper (or of running
+ * a registrar defined by IOCSH_FUNC_WRAP_REGISTRAR). 'allocs' and
+ * 'allocBytes' count the heap allocations made by this library,
+ * 'args' the iocshArg descriptors created (i.e., not shared; see
+ * ArgCache). Define IOCSH_DECL_WRAPPER_NO_PROFILE to compile the
+ * probes out.
  */
-template <> struct DropBraces<void> {
+struct RegCost {
+	epicsUInt64 ns;
+	size_t      allocs;
+	size_t      allocBytes;
+	size_t      args;
+};
 
-	template <typename R, typename ...A> struct TypeHelper {
-		typedef R (FuncType)(A...);
-	};
+class RegProbe {
+#ifndef IOCSH_DECL_WRAPPER_NO_PROFILE
+private:
+	epicsUInt64 t0_;
+	size_t      allocs_;
+	size_t      bytes_;
+	size_t      args_;
 
-	template <typename R, typename ...A>
-	static TypeHelper<R,A...> type(R (*f)(A...))
+public:
+	RegProbe()
+	: t0_    ( epicsMonotonicGet()                        ),
+	  allocs_( epicsAtomicGetSizeT( &AllocCount<>::allocs ) ),
+	  bytes_ ( epicsAtomicGetSizeT( &AllocCount<>::bytes  ) ),
+	  args_  ( ArgCache::getStats().descriptors             )
 	{
-		return TypeHelper<R,A...>();
 	}
 
-	template <typename R, typename C, typename ...A>
-	struct MemberTypeHelper {
-		typedef R (C::*MemberFuncType)(A...);
+	/* Cost since construction */
+	RegCost cost() const
+	{
+	RegCost c;
+		c.ns         = epicsMonotonicGet() - t0_;
+		c.allocs     = epicsAtomicGetSizeT( &AllocCount<>::allocs ) - allocs_;
+		c.allocBytes = epicsAtomicGetSizeT( &AllocCount<>::bytes  ) - bytes_;
+		c.args       = ArgCache::getStats().descriptors             - args_;
+		return c;
+	}
+#else
+public:
+	RegCost cost() const
+	{
+	RegCost c;
+		::memset( &c, 0, sizeof( c ) );
+		return c;
+	}
+#endif
+};
+
+/*
+ * Trace of wrapped calls: a fixed-size ring of the most recent
+ * calls with their (raw) arguments, duration and outcome. The
+ * record layout is plain C so that it can be inspected by a
+ * crash handler (see iocshWrapTraceSnapshot()).
+ */
+#ifndef IOCSH_DECL_WRAPPER_TRACE_SIZE
+#define IOCSH_DECL_WRAPPER_TRACE_SIZE   256  /* records; must be a power of two */
+#endif
+#ifndef IOCSH_DECL_WRAPPER_TRACE_ARGS
+#define IOCSH_DECL_WRAPPER_TRACE_ARGS   8    /* arguments recorded per call      */
+#endif
+#ifndef IOCSH_DECL_WRAPPER_TRACE_STRLEN
+#define IOCSH_DECL_WRAPPER_TRACE_STRLEN 24   /* string arguments are truncated   */
+#endif
+
+}
+
+extern "C" {
+
+typedef enum IocshWrapTraceOutcome {
+	IocshWrapTraceRunning         = 0,
+	IocshWrapTraceOK              = 1,
+	IocshWrapTraceConversionError = 2,
+	IocshWrapTraceException       = 3
+} IocshWrapTraceOutcome;
+
+typedef struct IocshWrapTraceArg {
+	int type; /* iocshArgType; -1 if the value was not recorded */
+	union {
+		int    ival;
+		double dval;
+		char   sval[ IOCSH_DECL_WRAPPER_TRACE_STRLEN ];
+	} val;
+} IocshWrapTraceArg;
+
+typedef struct IocshWrapTraceRecord {
+	size_t            seq;        /* 1, 2, ...; 0 if empty, (size_t)-1 while the slot is written */
+	epicsUInt64       stamp;      /* epicsMonotonicGet() at entry           */
+	epicsUInt64       durationNs;
+	const char       *name;
+	int               outcome;    /* IocshWrapTraceOutcome                  */
+	int               nargs;      /* number of recorded arguments           */
+	IocshWrapTraceArg args[ IOCSH_DECL_WRAPPER_TRACE_ARGS ];
+} IocshWrapTraceRecord;
+
+}
+
+namespace IocshDeclWrapper {
+
+/*
+ * Run-time state of a wrapped function: the 'quiet' flag
+ * (see PrintControl) and call statistics (see CallStatsReport).
+ * Every wrapped function 'f' owns one instance, PerWrapper<F, f>::state,
+ * which is zero-initialized at load time and registered by name
+ * (WrapperRegistry) when the wrapper is registered.
+ */
+#ifndef IOCSH_DECL_WRAPPER_STATS_BUCKETS
+#define IOCSH_DECL_WRAPPER_STATS_BUCKETS 32
+#endif
+
+/*
+ * A 64-bit sum of times (ns) kept with the size_t epicsAtomic operations
+ * (there are no 64-bit ones). Where size_t has 32 bits the sum is split
+ * into two words and 'lo' carries into 'hi'; a reader racing with the
+ * carry may see a sum that is 2^32 ns short for a moment.
+ */
+struct StatTime {
+	size_t lo;
+	size_t hi;
+
+	static bool wide()
+	{
+		return sizeof(size_t) >= sizeof(epicsUInt64);
+	}
+
+	void add(epicsUInt64 ns)
+	{
+	size_t l = (size_t)ns;
+	size_t h;
+		if ( wide() ) {
+			epicsAtomicAddSizeT( &lo, l );
+			return;
+		}
+		l = (size_t)( ns & 0xffffffffu );
+		h = (size_t)( ns >> 32 );
+		if ( epicsAtomicAddSizeT( &lo, l ) < l ) {
+			h++;
+		}
+		if ( h ) {
+			epicsAtomicAddSizeT( &hi, h );
+		}
+	}
+
+	epicsUInt64 get() const
+	{
+	size_t h, l;
+		if ( wide() ) {
+			return epicsAtomicGetSizeT( &lo );
+		}
+		do {
+			h = epicsAtomicGetSizeT( &hi );
+			l = epicsAtomicGetSizeT( &lo );
+		} while ( h != epicsAtomicGetSizeT( &hi ) );
+		return ( (epicsUInt64)h << 32 ) + l;
+	}
+
+	void clear()
+	{
+		epicsAtomicSetSizeT( &lo, 0 );
+		epicsAtomicSetSizeT( &hi, 0 );
+	}
+};
+
+/*
+ * The maximum of times (ns) in a single word; kept in us (saturating
+ * after ~71 minutes) where size_t has 32 bits.
+ */
+struct StatMaxTime {
+	size_t val;
+
+	void raise(epicsUInt64 ns)
+	{
+	size_t v, old, cur;
+		if ( StatTime::wide() ) {
+			v = (size_t)ns;
+		} else {
+			v = ns / 1000 > 0xffffffffu ? (size_t)0xffffffffu : (size_t)( ns / 1000 );
+		}
+		old = epicsAtomicGetSizeT( &val );
+		while ( v > old && ( cur = epicsAtomicCmpAndSwapSizeT( &val, old, v ) ) != old ) {
+			old = cur;
+		}
+	}
+
+	epicsUInt64 get() const
+	{
+	size_t v = epicsAtomicGetSizeT( &val );
+		return StatTime::wide() ? (epicsUInt64)v : (epicsUInt64)v * 1000;
+	}
+
+	void clear()
+	{
+		epicsAtomicSetSizeT( &val, 0 );
+	}
+};
+
+/*
+ * Counters are updated with epicsAtomic operations; times are
+ * in ns. 'hist[i]' counts calls that took [2^i, 2^(i+1)) ns;
+ * the last bucket is open-ended.
+ */
+struct CallStats {
+	size_t      calls;
+	size_t      convErrors;
+	size_t      exceptions;
+	StatTime    totalNs;
+	StatMaxTime maxNs;
+	size_t      hist[ IOCSH_DECL_WRAPPER_STATS_BUCKETS ];
+};
+
+/* A copy of CallStats with 64-bit times (see CallStatsReport) */
+struct CallStatsSnapshot {
+	size_t      calls;
+	size_t      convErrors;
+	size_t      exceptions;
+	epicsUInt64 totalNs;
+	epicsUInt64 maxNs;
+	size_t      hist[ IOCSH_DECL_WRAPPER_STATS_BUCKETS ];
+};
+
+struct WrapperState {
+	int                 quiet;
+	CallStats           stats;
+	const iocshFuncDef *def;
+	/* startup profile */
+	RegCost             regCost;
+	const char         *registrar;
+};
+
+/* Global flags; exported as iocsh variables */
+template <int USER = 0> struct QuietAll {
+	static int value;
+};
+
+template <int USER> int QuietAll<USER>::value = 0;
+
+template <int USER = 0> struct StatsEnabled {
+	static int value;
+};
+
+template <int USER> int StatsEnabled<USER>::value = 1;
+
+template <typename F, F *f> struct PerWrapper {
+	static WrapperState state;
+
+	static bool quiet()
+	{
+		return ( QuietAll<0>::value | state.quiet );
+	}
+};
+
+template <typename F, F *f> WrapperState PerWrapper<F, f>::state;
+
+/*
+ * The trace ring. Writers obtain a sequence number with an atomic
+ * increment, take ownership of the slot by swapping its 'seq' to
+ * BUSY and publish it seqlock-style; there are no locks. A writer
+ * that finds the slot still owned by a writer from an earlier lap
+ * or already holding a newer record (only possible with many
+ * concurrent calls) drops its record.
+ * The ring lives in static storage. Tracing is off by default;
+ * it is enabled by the iocsh variable 'iocshWrapTraceEnable'.
+ */
+template <int USER = 0> class TraceRing {
+private:
+	static size_t               head_;
+	static IocshWrapTraceRecord ring_[ IOCSH_DECL_WRAPPER_TRACE_SIZE ];
+
+	static const size_t         BUSY = (size_t)-1;
+
+	/*
+	 * Take ownership of the slot for 'seq' if it holds 'expected'; fails
+	 * if another writer owns it or it holds a record newer than 'seq'
+	 * (a writer preempted for a lap or more must not overwrite it).
+	 */
+	static bool claim(IocshWrapTraceRecord *r, size_t seq, size_t expected)
+	{
+		return    expected != BUSY
+		       && (ptrdiff_t)( seq - expected ) >= 0
+		       && epicsAtomicCmpAndSwapSizeT( &r->seq, expected, BUSY ) == expected;
+	}
+
+	static IocshWrapTraceRecord *slot(size_t seq)
+	{
+		return &ring_[ (seq - 1) & (IOCSH_DECL_WRAPPER_TRACE_SIZE - 1) ];
+	}
+
+	/* Copy a consistent version of slot 'seq'; false if it is busy or was overwritten */
+	static bool read(IocshWrapTraceRecord *dst, size_t seq)
+	{
+	IocshWrapTraceRecord *r = slot( seq );
+		if ( epicsAtomicGetSizeT( &r->seq ) != seq ) {
+			return false;
+		}
+		epicsAtomicReadMemoryBarrier();
+		::memcpy( dst, r, sizeof( *dst ) );
+		epicsAtomicReadMemoryBarrier();
+		return epicsAtomicGetSizeT( &r->seq ) == seq;
+	}
+
+public:
+	static int enabled;
+
+	/* Record entry into a wrapper; returns the sequence number (token for 'end()'), 0 if dropped */
+	static size_t begin(const iocshFuncDef *def, const iocshArgBuf *args, epicsUInt64 stamp)
+	{
+	size_t                seq = epicsAtomicIncrSizeT( &head_ );
+	IocshWrapTraceRecord *r   = slot( seq );
+	int                   i, n;
+
+		if ( ! claim( r, seq, epicsAtomicGetSizeT( &r->seq ) ) ) {
+			return 0;
+		}
+		epicsAtomicWriteMemoryBarrier();
+		r->stamp      = stamp;
+		r->durationNs = 0;
+		r->name       = def ? def->name : "<unknown>";
+		r->outcome    = IocshWrapTraceRunning;
+		n             = def ? def->nargs : 0;
+		if ( n > IOCSH_DECL_WRAPPER_TRACE_ARGS ) {
+			n = IOCSH_DECL_WRAPPER_TRACE_ARGS;
+		}
+		r->nargs      = n;
+		for ( i = 0; i < n; i++ ) {
+			IocshWrapTraceArg *a = &r->args[i];
+			a->type = def->arg[i]->type;
+			switch ( def->arg[i]->type ) {
+				case iocshArgInt:
+					a->val.ival = args[i].ival;
+				break;
+				case iocshArgDouble:
+					a->val.dval = args[i].dval;
+				break;
+				case iocshArgString:
+				case iocshArgPersistentString:
+					if ( args[i].sval ) {
+						::strncpy( a->val.sval, args[i].sval, sizeof( a->val.sval ) - 1 );
+						a->val.sval[ sizeof( a->val.sval ) - 1 ] = 0;
+					} else {
+						a->type = -1;
+					}
+				break;
+				default:
+					a->type = -1;
+				break;
+			}
+		}
+		epicsAtomicWriteMemoryBarrier();
+		epicsAtomicSetSizeT( &r->seq, seq );
+		return seq;
+	}
+
+	/* Record duration and outcome (unless the slot has been reused in the meantime) */
+	static void end(size_t seq, epicsUInt64 durationNs, int outcome)
+	{
+	IocshWrapTraceRecord *r = slot( seq );
+		if ( ! claim( r, seq, seq ) ) {
+			return;
+		}
+		epicsAtomicWriteMemoryBarrier();
+		r->durationNs = durationNs;
+		r->outcome    = outcome;
+		epicsAtomicWriteMemoryBarrier();
+		epicsAtomicSetSizeT( &r->seq, seq );
+	}
+
+	/*
+	 * Copy (up to) the 'n' most recent records into 'buf', oldest first;
+	 * returns the number of records copied. Lock-free and does not
+	 * allocate memory (may be used from a crash handler).
+	 */
+	static size_t snapshot(IocshWrapTraceRecord *buf, size_t n)
+	{
+	size_t last = epicsAtomicGetSizeT( &head_ );
+	size_t seq, got;
+
+		if ( n > IOCSH_DECL_WRAPPER_TRACE_SIZE ) {
+			n = IOCSH_DECL_WRAPPER_TRACE_SIZE;
+		}
+		if ( n > last ) {
+			n = last;
+		}
+		for ( got = 0, seq = last - n + 1; seq <= last; seq++ ) {
+			if ( read( &buf[got], seq ) ) {
+				got++;
+			}
+		}
+		return got;
+	}
+
+	static void clear()
+	{
+	size_t i;
+		for ( i = 0; i < IOCSH_DECL_WRAPPER_TRACE_SIZE; i++ ) {
+			epicsAtomicSetSizeT( &ring_[i].seq, 0 );
+		}
+	}
+};
+
+template <int USER> size_t               TraceRing<USER>::head_   = 0;
+template <int USER> int                  TraceRing<USER>::enabled = 0;
+template <int USER> IocshWrapTraceRecord TraceRing<USER>::ring_[ IOCSH_DECL_WRAPPER_TRACE_SIZE ];
+
+/*
+ * Accounts for one call of a wrapper; the constructor starts the
+ * clock (and records the call in the trace ring), the destructor
+ * records the duration and outcome. If statistics and tracing are
+ * disabled at run-time the cost is a (predictable) test of two flags;
+ * define IOCSH_DECL_WRAPPER_NO_STATS and IOCSH_DECL_WRAPPER_NO_TRACE
+ * to compile them out.
+ */
+class CallMonitor {
+#if !defined(IOCSH_DECL_WRAPPER_NO_STATS) || !defined(IOCSH_DECL_WRAPPER_NO_TRACE)
+private:
+	CallStats   *st_;
+	size_t       seq_;     /* trace token; 0 if not tracing */
+	epicsUInt64  t0_;
+	int          outcome_;
+
+	CallMonitor(const CallMonitor &);
+	CallMonitor & operator=(const CallMonitor &);
+
+	static bool statsOn()
+	{
+#ifndef IOCSH_DECL_WRAPPER_NO_STATS
+		return StatsEnabled<0>::value;
+#else
+		return false;
+#endif
+	}
+
+	static bool traceOn()
+	{
+#ifndef IOCSH_DECL_WRAPPER_NO_TRACE
+		return TraceRing<0>::enabled;
+#else
+		return false;
+#endif
+	}
+
+	static void record(CallStats *st, epicsUInt64 ns)
+	{
+	epicsUInt64 v;
+	unsigned    b;
+
+		epicsAtomicIncrSizeT( &st->calls );
+		st->totalNs.add( ns );
+		st->maxNs.raise( ns );
+		for ( b = 0, v = ns; (v >>= 1) && b < IOCSH_DECL_WRAPPER_STATS_BUCKETS - 1; b++ )
+			;
+		epicsAtomicIncrSizeT( &st->hist[b] );
+	}
+
+public:
+	CallMonitor(WrapperState *ws, const iocshArgBuf *args)
+	: st_     ( statsOn() ? &ws->stats : 0 ),
+	  seq_    ( 0                          ),
+	  t0_     ( 0                          ),
+	  outcome_( IocshWrapTraceOK           )
+	{
+		if ( st_ || traceOn() ) {
+			t0_ = epicsMonotonicGet();
+			if ( traceOn() ) {
+				seq_ = TraceRing<0>::begin( ws->def, args, t0_ );
+			}
+		}
+	}
+
+	void conversionError()
+	{
+		outcome_ = IocshWrapTraceConversionError;
+		if ( st_ ) {
+			epicsAtomicIncrSizeT( &st_->convErrors );
+		}
+	}
+
+	void exception()
+	{
+		outcome_ = IocshWrapTraceException;
+		if ( st_ ) {
+			epicsAtomicIncrSizeT( &st_->exceptions );
+		}
+	}
+
+	~CallMonitor()
+	{
+		if ( st_ || seq_ ) {
+			epicsUInt64 dt = epicsMonotonicGet() - t0_;
+			if ( st_ ) {
+				record( st_, dt );
+			}
+			if ( seq_ ) {
+				TraceRing<0>::end( seq_, dt, outcome_ );
+			}
+		}
+	}
+#else
+public:
+	CallMonitor(WrapperState *, const iocshArgBuf *)
+	{
+	}
+
+	void conversionError()
+	{
+	}
+
+	void exception()
+	{
+	}
+#endif
+};
+
+#ifndef IOCSH_DECL_WRAPPER_NOINLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define IOCSH_DECL_WRAPPER_NOINLINE __attribute__((noinline))
+#else
+#define IOCSH_DECL_WRAPPER_NOINLINE
+#endif
+#endif
+
+/*
+ * The part of a wrapper that does not depend on the user function:
+ * print control, statistics/tracing, the exception handlers and error
+ * messages and printing of mutable arguments. This code exists only
+ * once; every wrapper merely contributes a 'Thunk' which converts the
+ * arguments, calls the user function and prints the result.
+ */
+class WrapperCall {
+public:
+	/*
+	 * Per-function hot path; called with the output buffer and whether to print.
+	 * Returns the message of a conversion failure reported by Context::fail()
+	 * (the user function was not called) or NULL.
+	 */
+	typedef const char * (*Thunk)(const iocshArgBuf *args, PrintBuffer *out, bool doPrint);
+
+	static void conversionFailed(CallMonitor *mon, const char *msg)
+	{
+		mon->conversionError();
+		errlogPrintf( "Error: Invalid Argument -- %s\n", msg );
+	}
+
+	static IOCSH_DECL_WRAPPER_NOINLINE void invoke(WrapperState *ws, const iocshArgBuf *args, bool print, Thunk thunk)
+	{
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+		CallMonitor mon( ws, args );
+		PrintBuffer out;
+		const char *err;
+		try {
+			if ( (err = thunk( args, &out, print && ! ( QuietAll<0>::value | ws->quiet ) )) ) {
+				conversionFailed( &mon, err );
+			}
+		} catch ( ConversionError &e ) {
+			conversionFailed( &mon, e.what() );
+		} catch ( std::exception &e ) {
+			mon.exception();
+			errlogPrintf( "Error: Exception -- %s\n", e.what() );
+		} catch ( ... ) {
+			mon.exception();
+			errlogPrintf( "Error: Unknown Exception\n" );
+		}
+#else
+		invokeNoThrow( ws, args, print, thunk );
+#endif
+	}
+
+	/*
+	 * Variant for thunks which cannot throw (see NoThrowCall); no
+	 * exception handlers. Should the thunk throw nevertheless then
+	 * std::terminate() is called.
+	 */
+	static IOCSH_DECL_WRAPPER_NOINLINE void invokeNoThrow(WrapperState *ws, const iocshArgBuf *args, bool print, Thunk thunk) IOCSH_DECL_WRAPPER_NOEXCEPT
+	{
+		CallMonitor mon( ws, args );
+		PrintBuffer out;
+		const char *err;
+		if ( (err = thunk( args, &out, print && ! ( QuietAll<0>::value | ws->quiet ) )) ) {
+			conversionFailed( &mon, err );
+		}
+	}
+
+	/* Print the mutable arguments recorded in 'ctx' */
+	static IOCSH_DECL_WRAPPER_NOINLINE void printArgs(ArgPrinterType printArgs, Context *ctx)
+	{
+		if ( printArgs != ArgPrinterBase::printArgs && ctx->getPrintBuffer() ) {
+			/* user's ArgPrinter may not use the buffer */
+			ctx->getPrintBuffer()->flush();
+		}
+		printArgs( ctx );
+	}
+};
+
+/*
+ * Directory of wrapped functions (by iocsh name). Entries are
+ * never removed.
+ */
+class WrapperRegistry {
+public:
+	struct Entry {
+		const char   *name;
+		WrapperState *state;
+		Entry        *next;
+	};
+
+private:
+	epicsMutexId  mtx_;
+	Entry        *entries_;
+
+	WrapperRegistry()
+	: mtx_    ( epicsMutexMustCreate() ),
+	  entries_( 0 )
+	{
+	}
+
+	WrapperRegistry(const WrapperRegistry &);
+	WrapperRegistry & operator=(const WrapperRegistry &);
+
+	static WrapperRegistry *get()
+	{
+	static WrapperRegistry theRegistry;
+		return &theRegistry;
+	}
+
+public:
+	static void add(const char *name, WrapperState *state)
+	{
+	WrapperRegistry *r = get();
+	Entry           *e = new Entry;
+		AllocCount<>::add( sizeof( *e ) );
+		e->name  = name;
+		e->state = state;
+		epicsMutexMustLock( r->mtx_ );
+		e->next     = r->entries_;
+		r->entries_ = e;
+		epicsMutexUnlock( r->mtx_ );
+	}
+
+	/* Collect entries matching a glob pattern (NULL or "" match all); returns number of matches */
+	static size_t find(std::vector<const Entry *> *matches, const char *pattern)
+	{
+	WrapperRegistry *r = get();
+	const Entry     *e;
+	size_t           n = 0;
+		if ( pattern && ! *pattern ) {
+			pattern = 0;
+		}
+		epicsMutexMustLock( r->mtx_ );
+		for ( e = r->entries_; e; e = e->next ) {
+			if ( ! pattern || epicsStrGlobMatch( e->name, pattern ) ) {
+				matches->push_back( e );
+				n++;
+			}
+		}
+		epicsMutexUnlock( r->mtx_ );
+		return n;
+	}
+};
+
+/*
+ * Run-time suppression of printing (result and mutable arguments).
+ *
+ * Every wrapped function has a 'quiet' flag; in addition there is
+ * a global flag which is exported as the iocsh variable
+ * 'iocshWrapQuietAll'. The 'iocshWrapQuiet' command sets the flags:
+ *
+ *   iocshWrapQuiet                 # list quiet functions
+ *   iocshWrapQuiet '*' on          # global
+ *   iocshWrapQuiet 'my*' on|off    # functions matching a glob pattern
+ *
+ * The wrappers merely test the flags; when quiet they skip all
+ * formatting and console output.
+ */
+class PrintControl {
+private:
+	PrintControl()
+	{
+	static const iocshArg     patArg    = { "func_pattern|*", iocshArgString };
+	static const iocshArg     onArg     = { "on|off",         iocshArgString };
+	static const iocshArg    *quietArgs[] = { &patArg, &onArg };
+	static const iocshFuncDef quietDef  = { "iocshWrapQuiet", 2, quietArgs };
+	static const iocshVarDef  vars[]    = {
+		{ "iocshWrapQuietAll", iocshArgInt, (void*)&QuietAll<0>::value },
+		{ 0,                   iocshArgInt, 0                          }
+	};
+
+		iocshRegister( &quietDef, quietCmd );
+		iocshRegisterVariable( vars );
+	}
+
+	PrintControl(const PrintControl &);
+	PrintControl & operator=(const PrintControl &);
+
+	static void list()
+	{
+	std::vector<const WrapperRegistry::Entry *> v;
+	size_t                                      i;
+		epicsStdoutPrintf("Printing globally %s\n", QuietAll<0>::value ? "OFF" : "ON");
+		WrapperRegistry::find( &v, 0 );
+		for ( i = 0; i < v.size(); i++ ) {
+			if ( v[i]->state->quiet ) {
+				epicsStdoutPrintf("  quiet: %s\n", v[i]->name);
+			}
+		}
+	}
+
+	static void quietCmd(const iocshArgBuf *args)
+	{
+	const char *pat = args[0].sval;
+	const char *on  = args[1].sval;
+	int         val;
+
+		if ( ! pat ) {
+			list();
+			return;
+		}
+		if ( ! on || 0 == ::strcmp( on, "on" ) || 0 == ::strcmp( on, "1" ) ) {
+			val = 1;
+		} else if ( 0 == ::strcmp( on, "off" ) || 0 == ::strcmp( on, "0" ) ) {
+			val = 0;
+		} else {
+			errlogPrintf("Usage: iocshWrapQuiet [<func_pattern>|'*'] [on|off]\n");
+			return;
+		}
+		if ( 0 == ::strcmp( pat, "*" ) ) {
+			QuietAll<0>::value = val;
+		} else if ( 0 == set( pat, val ) ) {
+			errlogPrintf("iocshWrapQuiet: no wrapped function matches '%s'\n", pat);
+		}
+	}
+
+public:
+	/* Register the iocsh command and variable (once) */
+	static void init()
+	{
+	static PrintControl theControl;
+	}
+
+	/* Set the flags of all functions matching a glob pattern; returns number of matches */
+	static unsigned set(const char *pattern, bool quiet)
+	{
+	std::vector<const WrapperRegistry::Entry *> v;
+	size_t                                      i;
+		WrapperRegistry::find( &v, pattern );
+		for ( i = 0; i < v.size(); i++ ) {
+			v[i]->state->quiet = quiet;
+		}
+		return v.size();
+	}
+
+	static void setAll(bool quiet)
+	{
+		QuietAll<0>::value = quiet;
+	}
+};
+
+/*
+ * Report call statistics:
+ *
+ *   iocshWrapStats [<func_pattern>] [name|calls|time|avg|max|errors|reset]
+ *
+ * lists the functions matching the pattern which have been called,
+ * sorted by the given key (default: 'time', i.e., total time). If a
+ * single function is listed then its latency histogram is printed
+ * as well. 'reset' clears the statistics of the matching functions.
+ * Statistics are collected while the iocsh variable
+ * 'iocshWrapStatsEnable' is nonzero (default).
+ */
+class CallStatsReport {
+public:
+	struct Row {
+		const char        *name;
+		CallStatsSnapshot  st;
+	};
+
+private:
+	typedef bool (*Cmp)(const Row &, const Row &);
+
+	CallStatsReport()
+	{
+	static const iocshArg     patArg    = { "func_pattern",                           iocshArgString };
+	static const iocshArg     sortArg   = { "name|calls|time|avg|max|errors|reset", iocshArgString };
+	static const iocshArg    *statsArgs[] = { &patArg, &sortArg };
+	static const iocshFuncDef statsDef  = { "iocshWrapStats", 2, statsArgs };
+	static const iocshVarDef  vars[]    = {
+		{ "iocshWrapStatsEnable", iocshArgInt, (void*)&StatsEnabled<0>::value },
+		{ 0,                      iocshArgInt, 0                              }
+	};
+
+		iocshRegister( &statsDef, statsCmd );
+		iocshRegisterVariable( vars );
+	}
+
+	CallStatsReport(const CallStatsReport &);
+	CallStatsReport & operator=(const CallStatsReport &);
+
+	static double avg(const Row &r)
+	{
+		return r.st.calls ? (double)r.st.totalNs / (double)r.st.calls : 0.0;
+	}
+
+	static bool byName  (const Row &a, const Row &b) { return ::strcmp( a.name, b.name ) < 0;       }
+	static bool byCalls (const Row &a, const Row &b) { return a.st.calls   > b.st.calls;             }
+	static bool byTime  (const Row &a, const Row &b) { return a.st.totalNs > b.st.totalNs;           }
+	static bool byAvg   (const Row &a, const Row &b) { return avg( a )     > avg( b );               }
+	static bool byMax   (const Row &a, const Row &b) { return a.st.maxNs   > b.st.maxNs;             }
+	static bool byErrors(const Row &a, const Row &b)
+	{
+		return a.st.convErrors + a.st.exceptions > b.st.convErrors + b.st.exceptions;
+	}
+
+	static void snapshot(CallStatsSnapshot *d, CallStats *s)
+	{
+	unsigned i;
+		d->calls      = epicsAtomicGetSizeT( &s->calls      );
+		d->convErrors = epicsAtomicGetSizeT( &s->convErrors );
+		d->exceptions = epicsAtomicGetSizeT( &s->exceptions );
+		d->totalNs    = s->totalNs.get();
+		d->maxNs      = s->maxNs.get();
+		for ( i = 0; i < IOCSH_DECL_WRAPPER_STATS_BUCKETS; i++ ) {
+			d->hist[i] = epicsAtomicGetSizeT( &s->hist[i] );
+		}
+	}
+
+	static void reset(CallStats *s)
+	{
+	unsigned i;
+		epicsAtomicSetSizeT( &s->calls,      0 );
+		epicsAtomicSetSizeT( &s->convErrors, 0 );
+		epicsAtomicSetSizeT( &s->exceptions, 0 );
+		s->totalNs.clear();
+		s->maxNs.clear();
+		for ( i = 0; i < IOCSH_DECL_WRAPPER_STATS_BUCKETS; i++ ) {
+			epicsAtomicSetSizeT( &s->hist[i], 0 );
+		}
+	}
+
+	static void printHistogram(const Row &r)
+	{
+	unsigned i;
+		epicsStdoutPrintf("Latency histogram of '%s' (ns):\n", r.name);
+		for ( i = 0; i < IOCSH_DECL_WRAPPER_STATS_BUCKETS; i++ ) {
+			if ( r.st.hist[i] ) {
+				if ( i < IOCSH_DECL_WRAPPER_STATS_BUCKETS - 1 ) {
+					epicsStdoutPrintf("  [%12lu, %12lu): %lu\n", i ? 1UL << i : 0UL, 2UL << i, (unsigned long)r.st.hist[i]);
+				} else {
+					epicsStdoutPrintf("  [%12lu,          ...): %lu\n", 1UL << i, (unsigned long)r.st.hist[i]);
+				}
+			}
+		}
+	}
+
+	static void statsCmd(const iocshArgBuf *args)
+	{
+	const char *key = args[1].sval ? args[1].sval : "time";
+	Cmp         cmp;
+
+		if        ( 0 == ::strcmp( key, "reset"  ) ) {
+			cmp = 0;
+		} else if ( 0 == ::strcmp( key, "name"   ) ) {
+			cmp = byName;
+		} else if ( 0 == ::strcmp( key, "calls"  ) ) {
+			cmp = byCalls;
+		} else if ( 0 == ::strcmp( key, "time"   ) ) {
+			cmp = byTime;
+		} else if ( 0 == ::strcmp( key, "avg"    ) ) {
+			cmp = byAvg;
+		} else if ( 0 == ::strcmp( key, "max"    ) ) {
+			cmp = byMax;
+		} else if ( 0 == ::strcmp( key, "errors" ) ) {
+			cmp = byErrors;
+		} else {
+			errlogPrintf("Usage: iocshWrapStats [<func_pattern>] [name|calls|time|avg|max|errors|reset]\n");
+			return;
+		}
+		if ( cmp ) {
+			report( args[0].sval, cmp );
+		} else {
+			std::vector<const WrapperRegistry::Entry *> v;
+			size_t                                      i;
+			WrapperRegistry::find( &v, args[0].sval );
+			for ( i = 0; i < v.size(); i++ ) {
+				reset( &v[i]->state->stats );
+			}
+		}
+	}
+
+public:
+	/* Register the iocsh command and variable (once) */
+	static void init()
+	{
+	static CallStatsReport theReport;
+	}
+
+	/* Snapshot the statistics of functions matching 'pattern' (NULL: all) */
+	static void get(std::vector<Row> *rows, const char *pattern)
+	{
+	std::vector<const WrapperRegistry::Entry *> v;
+	size_t                                      i;
+	Row                                         r;
+		WrapperRegistry::find( &v, pattern );
+		for ( i = 0; i < v.size(); i++ ) {
+			r.name = v[i]->name;
+			snapshot( &r.st, &v[i]->state->stats );
+			rows->push_back( r );
+		}
+	}
+
+	static void report(const char *pattern, bool (*cmp)(const Row &, const Row &) = byTime)
+	{
+	std::vector<Row> rows;
+	size_t           i, n;
+
+		get( &rows, pattern );
+		for ( i = n = 0; i < rows.size(); i++ ) {
+			if ( rows[i].st.calls ) {
+				rows[n++] = rows[i];
+			}
+		}
+		rows.resize( n );
+		std::stable_sort( rows.begin(), rows.end(), cmp );
+
+		if ( ! StatsEnabled<0>::value ) {
+			epicsStdoutPrintf("(statistics currently disabled; 'var iocshWrapStatsEnable 1')\n");
+		}
+		epicsStdoutPrintf("%-32s %10s %8s %8s %12s %10s %10s\n",
+			"function", "calls", "convErr", "except", "total[ms]", "avg[us]", "max[us]");
+		for ( i = 0; i < rows.size(); i++ ) {
+			epicsStdoutPrintf("%-32s %10lu %8lu %8lu %12.3f %10.3f %10.3f\n",
+				rows[i].name,
+				(unsigned long)rows[i].st.calls,
+				(unsigned long)rows[i].st.convErrors,
+				(unsigned long)rows[i].st.exceptions,
+				(double)rows[i].st.totalNs * 1.0E-6,
+				avg( rows[i] )             * 1.0E-3,
+				(double)rows[i].st.maxNs   * 1.0E-3);
+		}
+		if ( 1 == rows.size() ) {
+			printHistogram( rows[0] );
+		}
+	}
+};
+
+/*
+ * Dump the trace ring:
+ *
+ *   iocshWrapTrace [<n>]
+ *
+ * prints the 'n' (default: all) most recent calls, oldest first.
+ * Tracing is enabled by 'var iocshWrapTraceEnable 1'.
+ */
+class TraceReport {
+private:
+	TraceReport();
+
+	TraceReport(const TraceReport &);
+	TraceReport & operator=(const TraceReport &);
+
+	static const char *outcome(int o)
+	{
+		switch ( o ) {
+			case IocshWrapTraceRunning:         return "RUNNING";
+			case IocshWrapTraceOK:              return "OK";
+			case IocshWrapTraceConversionError: return "CONV_ERR";
+			case IocshWrapTraceException:       return "EXCEPTION";
+			default:                            break;
+		}
+		return "?";
+	}
+
+	static void traceCmd(const iocshArgBuf *args)
+	{
+		report( args[0].ival > 0 ? (size_t)args[0].ival : IOCSH_DECL_WRAPPER_TRACE_SIZE );
+	}
+
+public:
+	/* Register the iocsh command and variable (once) */
+	static void init()
+	{
+	static TraceReport theReport;
+	}
+
+	static void report(size_t n)
+	{
+	std::vector<IocshWrapTraceRecord> recs( n > IOCSH_DECL_WRAPPER_TRACE_SIZE ? IOCSH_DECL_WRAPPER_TRACE_SIZE : n );
+	size_t                            i;
+	int                               a;
+
+		if ( ! TraceRing<0>::enabled ) {
+			epicsStdoutPrintf("(tracing currently disabled; 'var iocshWrapTraceEnable 1')\n");
+		}
+		if ( recs.empty() ) {
+			return;
+		}
+		recs.resize( TraceRing<0>::snapshot( &recs[0], recs.size() ) );
+		epicsStdoutPrintf("%10s %16s %10s %-9s %s\n", "seq", "time[s]", "dur[us]", "outcome", "call");
+		for ( i = 0; i < recs.size(); i++ ) {
+			const IocshWrapTraceRecord &r = recs[i];
+			PrintBuffer                 out;
+			out.append( "%10lu %16.6f %10.3f %-9s %s(",
+				(unsigned long)r.seq, (double)r.stamp * 1.0E-9, (double)r.durationNs * 1.0E-3,
+				outcome( r.outcome ), r.name );
+			for ( a = 0; a < r.nargs; a++ ) {
+				const IocshWrapTraceArg &arg = r.args[a];
+				out.append( a ? ", " : "" );
+				switch ( arg.type ) {
+					case iocshArgInt:
+						out.append( "%d", arg.val.ival );
+					break;
+					case iocshArgDouble:
+						out.append( "%g", arg.val.dval );
+					break;
+					case iocshArgString:
+					case iocshArgPersistentString:
+						out.append( "\"%s%s\"", arg.val.sval,
+							::strlen( arg.val.sval ) == sizeof( arg.val.sval ) - 1 ? "..." : "" );
+					break;
+					default:
+						out.append( "?" );
+					break;
+				}
+			}
+			out.append( ")\n" );
+		}
+	}
+};
+
+
+/*
+ * Startup profile of the registrars (IOCSH_FUNC_WRAP_REGISTRAR)
+ * and of the individual wrappers:
+ *
+ *   iocshWrapStartup [time|allocs|bytes|args] [<max_functions>]
+ *
+ * lists the registrars and the wrapped functions sorted by the
+ * given cost (default: time).
+ */
+class StartupProfile {
+public:
+	struct Registrar {
+		const char *name;
+		unsigned    nfuncs;
+		RegCost     cost;
+		Registrar  *next;
+	};
+
+	struct Row {
+		const char *name;
+		const char *registrar;
+		unsigned    nfuncs;
+		RegCost     cost;
+	};
+
+private:
+	typedef bool (*Cmp)(const Row &, const Row &);
+
+	epicsMutexId  mtx_;
+	Registrar    *registrars_;
+	Registrar    *current_;
+
+	StartupProfile()
+	: mtx_       ( epicsMutexMustCreate() ),
+	  registrars_( 0 ),
+	  current_   ( 0 )
+	{
+	static const iocshArg     sortArg   = { "time|allocs|bytes|args", iocshArgString };
+	static const iocshArg     maxArg    = { "max_functions",          iocshArgInt    };
+	static const iocshArg    *profArgs[] = { &sortArg, &maxArg };
+	static const iocshFuncDef profDef   = { "iocshWrapStartup", 2, profArgs };
+
+		iocshRegister( &profDef, startupCmd );
+	}
+
+	StartupProfile(const StartupProfile &);
+	StartupProfile & operator=(const StartupProfile &);
+
+	static StartupProfile *get()
+	{
+	static StartupProfile theProfile;
+		return &theProfile;
+	}
+
+	static bool byTime  (const Row &a, const Row &b) { return a.cost.ns         > b.cost.ns;         }
+	static bool byAllocs(const Row &a, const Row &b) { return a.cost.allocs     > b.cost.allocs;     }
+	static bool byBytes (const Row &a, const Row &b) { return a.cost.allocBytes > b.cost.allocBytes; }
+	static bool byArgs  (const Row &a, const Row &b) { return a.cost.args       > b.cost.args;       }
+
+	static void startupCmd(const iocshArgBuf *args)
+	{
+	const char *key = args[0].sval ? args[0].sval : "time";
+	Cmp         cmp;
+
+		if        ( 0 == ::strcmp( key, "time"   ) ) {
+			cmp = byTime;
+		} else if ( 0 == ::strcmp( key, "allocs" ) ) {
+			cmp = byAllocs;
+		} else if ( 0 == ::strcmp( key, "bytes"  ) ) {
+			cmp = byBytes;
+		} else if ( 0 == ::strcmp( key, "args"   ) ) {
+			cmp = byArgs;
+		} else {
+			errlogPrintf("Usage: iocshWrapStartup [time|allocs|bytes|args] [<max_functions>]\n");
+			return;
+		}
+		report( cmp, args[1].ival > 0 ? (size_t)args[1].ival : (size_t)-1 );
+	}
+
+	/* Registrars are listed with the number of functions, functions with their registrar */
+	static void printRows(bool functions, std::vector<Row> *rows, Cmp cmp, size_t max)
+	{
+	size_t i;
+		std::stable_sort( rows->begin(), rows->end(), cmp );
+		epicsStdoutPrintf("%-32s %-24s %10s %7s %8s %5s\n",
+			functions ? "function" : "registrar", functions ? "registrar" : "functions",
+			"time[us]", "allocs", "bytes", "args");
+		for ( i = 0; i < rows->size() && i < max; i++ ) {
+			const Row &r = (*rows)[i];
+			PrintBuffer out;
+			out.append( "%-32s ", r.name );
+			if ( functions ) {
+				out.append( "%-24s ", r.registrar ? r.registrar : "-" );
+			} else {
+				out.append( "%-24u ", r.nfuncs );
+			}
+			out.append( "%10.3f %7lu %8lu %5lu\n",
+				(double)r.cost.ns * 1.0E-3,
+				(unsigned long)r.cost.allocs,
+				(unsigned long)r.cost.allocBytes,
+				(unsigned long)r.cost.args );
+		}
+	}
+
+public:
+	/* Register the iocsh command (once) */
+	static void init()
+	{
+		get();
+	}
+
+	/* Enter/leave a registrar (see RegistrarScope) */
+	static Registrar *beginRegistrar(const char *name)
+	{
+	StartupProfile *p = get();
+	Registrar      *r = new Registrar;
+		AllocCount<>::add( sizeof( *r ) );
+		r->name   = name;
+		r->nfuncs = 0;
+		::memset( &r->cost, 0, sizeof( r->cost ) );
+		epicsMutexMustLock( p->mtx_ );
+		r->next        = p->registrars_;
+		p->registrars_ = r;
+		p->current_    = r;
+		epicsMutexUnlock( p->mtx_ );
+		return r;
+	}
+
+	static void endRegistrar(Registrar *r, const RegCost &cost)
+	{
+	StartupProfile *p = get();
+		epicsMutexMustLock( p->mtx_ );
+		r->cost = cost;
+		if ( p->current_ == r ) {
+			p->current_ = 0;
+		}
+		epicsMutexUnlock( p->mtx_ );
+	}
+
+	/* Record the cost of registering a wrapper; attributes it to the current registrar */
+	static void addFunction(WrapperState *state, const RegCost &cost)
+	{
+	StartupProfile *p = get();
+		epicsMutexMustLock( p->mtx_ );
+		state->regCost   = cost;
+		state->registrar = p->current_ ? p->current_->name : 0;
+		if ( p->current_ ) {
+			p->current_->nfuncs++;
+		}
+		epicsMutexUnlock( p->mtx_ );
+	}
+
+	static void getRegistrars(std::vector<Row> *rows)
+	{
+	StartupProfile *p = get();
+	Registrar      *r;
+	Row             row;
+		epicsMutexMustLock( p->mtx_ );
+		for ( r = p->registrars_; r; r = r->next ) {
+			row.name      = r->name;
+			row.registrar = r->name;
+			row.nfuncs    = r->nfuncs;
+			row.cost      = r->cost;
+			rows->push_back( row );
+		}
+		epicsMutexUnlock( p->mtx_ );
+	}
+
+	static void getFunctions(std::vector<Row> *rows)
+	{
+	std::vector<const WrapperRegistry::Entry *> v;
+	size_t                                      i;
+	Row                                         row;
+		WrapperRegistry::find( &v, 0 );
+		for ( i = 0; i < v.size(); i++ ) {
+			row.name      = v[i]->name;
+			row.registrar = v[i]->state->registrar;
+			row.nfuncs    = 1;
+			row.cost      = v[i]->state->regCost;
+			rows->push_back( row );
+		}
+	}
+
+	static void report(bool (*cmp)(const Row &, const Row &) = byTime, size_t maxFunctions = (size_t)-1)
+	{
+	std::vector<Row> rows;
+		getRegistrars( &rows );
+		printRows( false, &rows, cmp, rows.size() );
+		rows.clear();
+		getFunctions( &rows );
+		printRows( true,  &rows, cmp, maxFunctions );
+	}
+};
+
+/*
+ * Profiles the body of a registrar (see IOCSH_FUNC_WRAP_REGISTRAR)
+ */
+class RegistrarScope {
+private:
+	RegProbe                    probe_;
+	StartupProfile::Registrar  *r_;
+
+	RegistrarScope(const RegistrarScope &);
+	RegistrarScope & operator=(const RegistrarScope &);
+
+public:
+	RegistrarScope(const char *name)
+	: r_( StartupProfile::beginRegistrar( name ) )
+	{
+	}
+
+	~RegistrarScope()
+	{
+		StartupProfile::endRegistrar( r_, probe_.cost() );
+	}
+};
+}
+
+/*
+ * C interface to the trace ring (may be used from a crash handler).
+ * These are ordinary (non-inline) functions so that C code can link
+ * against them; they are defined in the one translation unit which
+ * defines IOCSH_DECL_WRAPPER_DEFINE_C_API before including this header
+ * (the companion library, iocshDeclWrapperInst.cc, does).
+ */
+
+/*
+ * Copy (up to) the 'n' most recent records, oldest first, into 'buf';
+ * returns the number of records copied. Does not lock or allocate.
+ */
+extern "C" size_t
+iocshWrapTraceSnapshot(IocshWrapTraceRecord *buf, size_t n);
+
+/* Enable (nonzero) or disable (0) tracing; returns the previous setting */
+extern "C" int
+iocshWrapTraceEnable(int enable);
+
+#ifdef IOCSH_DECL_WRAPPER_DEFINE_C_API
+extern "C" size_t
+iocshWrapTraceSnapshot(IocshWrapTraceRecord *buf, size_t n)
+{
+	return IocshDeclWrapper::TraceRing<0>::snapshot( buf, n );
+}
+
+extern "C" int
+iocshWrapTraceEnable(int enable)
+{
+int prev = IocshDeclWrapper::TraceRing<0>::enabled;
+	IocshDeclWrapper::TraceRing<0>::enabled = enable;
+	return prev;
+}
+#endif
+
+namespace IocshDeclWrapper {
+
+inline
+TraceReport::TraceReport()
+{
+static const iocshArg     nArg        = { "n_records", iocshArgInt };
+static const iocshArg    *traceArgs[] = { &nArg };
+static const iocshFuncDef traceDef    = { "iocshWrapTrace", 1, traceArgs };
+static const iocshVarDef  vars[]      = {
+	{ "iocshWrapTraceEnable", iocshArgInt, (void*)&TraceRing<0>::enabled },
+	{ 0,                      iocshArgInt, 0                             }
+};
+	iocshRegister( &traceDef, TraceReport::traceCmd );
+	iocshRegisterVariable( vars );
+}
+
+/*
+ * Called by the wrapper macros when a wrapper is registered
+ */
+inline void
+registerWrapper(const iocshFuncDef *def, WrapperState *state, const RegProbe &probe)
+{
+	PrintControl::init();
+	CallStatsReport::init();
+	TraceReport::init();
+	StartupProfile::init();
+	state->def = def;
+	WrapperRegistry::add( def->name, state );
+	StartupProfile::addFunction( state, probe.cost() );
+}
+
+/*
+ * Static storage for a iocshFuncDef and the array of pointers
+ * to its N (interned) iocshArgs; every wrapper macro expansion
+ * owns one (function-local static) instance. This is a POD which
+ * is zero-initialized at load time and populated by 'init()' and
+ * 'setArg()' when the wrapper is registered.
+ *
+ * NOTE: the function name and argument help strings are
+ *       not copied; they must be string literals (or have
+ *       static storage duration).
+ */
+template <int N> struct FuncDefStorage {
+	iocshFuncDef    def;
+	const iocshArg *argp[ N > 0 ? N : 1 ];
+
+	iocshFuncDef *init(const char *fname)
+	{
+		def.name  = fname;
+		def.nargs = N;
+		def.arg   = argp;
+		return &def;
+	}
+
+	void setArg(int i, const iocshArg *a)
+	{
+		argp[i] = ArgCache::intern( a );
+	}
+};
+
+/*
+ * Explicit instantiations of the converters and printers for common
+ * types. The optional companion library (iocshDeclWrapperInst.cc,
+ * built with IOCSH_DECL_WRAPPER_LIB=YES) defines
+ * IOCSH_DECL_WRAPPER_INSTANTIATE and thus contains the only copy
+ * of these. Translation units that define
+ * IOCSH_DECL_WRAPPER_EXTERN_TEMPLATES (C++11 or later) merely see
+ * 'extern' declarations: they don't instantiate the members (the
+ * compiler may still inline them) but must link against the library.
+ */
+#if defined(IOCSH_DECL_WRAPPER_INSTANTIATE)
+#define IOCSH_DECL_WRAPPER_INST_KW
+#elif defined(IOCSH_DECL_WRAPPER_EXTERN_TEMPLATES) && __cplusplus >= 201103L
+#define IOCSH_DECL_WRAPPER_INST_KW extern
+#endif
+
+#ifdef IOCSH_DECL_WRAPPER_INST_KW
+#define IOCSH_DECL_WRAPPER_INST_SCALAR(KIND, T)                           \
+	IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<T,  T,  KIND>;     \
+	IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<T*, T*, KindScalp>;\
+	IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<T&, T&, KindScalr>;\
+	IOCSH_DECL_WRAPPER_INST_KW template struct PrintFmts<T>;                  \
+	IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<T, T>
+
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt, unsigned long long );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,          long long );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt, unsigned      long );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,               long );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt, unsigned       int );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,                int );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt, unsigned     short );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,              short );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt, unsigned      char );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,               char );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindInt,               bool );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindFlt,              float );
+IOCSH_DECL_WRAPPER_INST_SCALAR( KindFlt,             double );
+
+#undef IOCSH_DECL_WRAPPER_INST_SCALAR
+
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<std::complex<float>,        std::complex<float>,        KindCplx>;
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<std::complex<double>,       std::complex<double>,       KindCplx>;
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<std::complex<long double>,  std::complex<long double>,  KindCplx>;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<std::complex<float>,        std::complex<float>        >;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<std::complex<double>,       std::complex<double>       >;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<std::complex<long double>,  std::complex<long double>  >;
+
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<const std::string &, const std::string &, KindStr>;
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<std::string &,       std::string &,       KindStr>;
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<const std::string *, const std::string *, KindStrp>;
+IOCSH_DECL_WRAPPER_INST_KW template struct ConvertKind<std::string *,       std::string *,       KindStrp>;
+IOCSH_DECL_WRAPPER_INST_KW template struct Convert<std::string>;
+IOCSH_DECL_WRAPPER_INST_KW template struct Convert<const char *>;
+IOCSH_DECL_WRAPPER_INST_KW template struct Convert<char *>;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<std::string,   std::string  >;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<std::string *, std::string *>;
+IOCSH_DECL_WRAPPER_INST_KW template class  PrinterBase<const char *,  const char * >;
+IOCSH_DECL_WRAPPER_INST_KW template struct PrintFmts<const char *>;
+IOCSH_DECL_WRAPPER_INST_KW template struct PrintFmts<char *>;
+
+IOCSH_DECL_WRAPPER_INST_KW template struct ArgName<0>;
+
+#undef IOCSH_DECL_WRAPPER_INST_KW
+#endif
+
+};
+
+#if __cplusplus >= 201103L
+
+#include <initializer_list>
+#include <type_traits>
+#include <map>
+#include <epicsEvent.h>
+#if IOCSH_DECL_WRAPPER_PARALLEL
+#include <tuple>
+#include <epicsThreadPool.h>
+#endif
+
+namespace IocshDeclWrapper {
+
+/*
+ * Generation of an object map (see IOCSH_MEMBER_WRAP). Member wrappers
+ * cache the objects they look up in maps with a 'tracked' generation
+ * (ObjectCache); the generation must change whenever an object is removed
+ * from the map or replaced. The default (untracked) looks up every call.
+ * TrackedObjectMap tracks its generation itself. For other map types
+ * specialize, e.g.,
+ *
+ *   template <> struct MapGeneration<MyMap> : NotifiedMapGeneration<MyMap> {};
+ *
+ * and call NotifiedMapGeneration<MyMap>::changed() after removing objects.
+ */
+template <typename M, int USER = 0> struct MapGeneration {
+	static const bool tracked = false;
+
+	static size_t get(const M *m)
+	{
+		return 0;
+	}
+};
+
+/* A generation per map type, changed by the user (shared by all maps of type M) */
+template <typename M> struct NotifiedMapGeneration {
+	static size_t generation;
+
+	static const bool tracked = true;
+
+	static size_t get(const M *m)
+	{
+		return epicsAtomicGetSizeT( &generation );
+	}
+
+	/* Invalidates the cached objects of all maps of type M */
+	static void changed()
+	{
+		epicsAtomicIncrSizeT( &generation );
+	}
+};
+
+template <typename M> size_t NotifiedMapGeneration<M>::generation = 0;
+
+/*
+ * A std::map of named objects which tracks its own generation: remove(),
+ * replace() and clear() invalidate the objects cached by member wrappers,
+ * nobody needs to be notified. Use it instead of a
+ * std::map<const std::string, C*>; like std::map it is not thread-safe
+ * (see ConcurrentObjectRegistry).
+ */
+template <typename C> class TrackedObjectMap {
+public:
+	typedef std::map<const std::string, C*> Map;
+	typedef typename Map::const_iterator    const_iterator;
+
+private:
+	Map    map_;
+	size_t gen_;
+
+	TrackedObjectMap(const TrackedObjectMap &);
+	TrackedObjectMap & operator=(const TrackedObjectMap &);
+
+	/* after the map was changed (see ObjectCache::lookup) */
+	void changed()
+	{
+		epicsAtomicIncrSizeT( &gen_ );
+	}
+
+public:
+	TrackedObjectMap()
+	: gen_( 0 )
+	{
+	}
+
+	/* Returns false if 'name' is NULL or already registered */
+	bool add(const char *name, C *obj)
+	{
+		return name && map_.insert( typename Map::value_type( name, obj ) ).second;
+	}
+
+	/* Returns false if 'name' is not registered */
+	bool remove(const char *name)
+	{
+	typename Map::iterator it;
+		if ( ! name || ( it = map_.find( name ) ) == map_.end() ) {
+			return false;
+		}
+		map_.erase( it );
+		changed();
+		return true;
+	}
+
+	/* Returns the old object (NULL if 'name' is not registered; nothing is changed in this case) */
+	C *replace(const char *name, C *obj)
+	{
+	typename Map::iterator it;
+	C                     *old;
+		if ( ! name || ( it = map_.find( name ) ) == map_.end() ) {
+			return 0;
+		}
+		old        = it->second;
+		it->second = obj;
+		changed();
+		return old;
+	}
+
+	void clear()
+	{
+		map_.clear();
+		changed();
+	}
+
+	/* Returns NULL if 'name' is not registered */
+	C *find(const char *name) const
+	{
+	const_iterator it;
+		if ( ! name || ( it = map_.find( name ) ) == map_.end() ) {
+			return 0;
+		}
+		return it->second;
+	}
+
+	/* The contract required by IOCSH_MEMBER_WRAP; throws std::out_of_range if 'name' is not registered */
+	C *at(const char *name) const
+	{
+	const_iterator it;
+		if ( ! name || ( it = map_.find( name ) ) == map_.end() ) {
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			throw std::out_of_range( std::string( "Object '" ) + ( name ? name : "<NULL>" ) + "' not found" );
+#else
+			::abort();
+#endif
+		}
+		return it->second;
+	}
+
+	C *at(const std::string &name) const
+	{
+		return at( name.c_str() );
+	}
+
+	size_t size() const
+	{
+		return map_.size();
+	}
+
+	const_iterator begin() const
+	{
+		return map_.begin();
+	}
+
+	const_iterator end() const
+	{
+		return map_.end();
+	}
+
+	size_t generation() const
+	{
+		return epicsAtomicGetSizeT( &gen_ );
+	}
+};
+
+template <typename C> struct MapGeneration< TrackedObjectMap<C> > {
+	static const bool tracked = true;
+
+	static size_t get(const TrackedObjectMap<C> *m)
+	{
+		return m->generation();
+	}
+};
+
+/*
+ * Direct-mapped cache of the objects looked up in map 'm' (shared by all
+ * members wrapped with this map), indexed by the hash of the object name.
+ * A slot is valid if its generation matches the map's. Slots are updated
+ * like the trace ring (sequence number; odd while written) so that lookups
+ * are lock-free. Names that do not fit into a slot are not cached.
+ */
+#ifndef IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE
+#define IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE   256  /* slots; must be a power of two */
+#endif
+#ifndef IOCSH_DECL_WRAPPER_OBJ_CACHE_KEYLEN
+#define IOCSH_DECL_WRAPPER_OBJ_CACHE_KEYLEN 40   /* longer names are not cached   */
+#endif
+
+template <typename M, M m, bool TRACKED = MapGeneration<typename std::remove_pointer<M>::type>::tracked>
+class ObjectCache {
+public:
+	template <typename C> static C *lookup(const char *name)
+	{
+		return m->at( name );
+	}
+};
+
+template <typename M, M m>
+class ObjectCache<M, m, true> {
+private:
+	typedef MapGeneration<typename std::remove_pointer<M>::type> Generation;
+
+	struct Slot {
+		size_t  seq;
+		size_t  gen;
+		void   *obj;
+		char    key[ IOCSH_DECL_WRAPPER_OBJ_CACHE_KEYLEN ];
+	};
+
+	static Slot slots_[ IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE ];
+
+	/* Mixes the length and the first and last (up to) 8 characters; also computes the length */
+	static size_t hash(const char *name, size_t *len)
+	{
+	epicsUInt64 h = 0, t = 0;
+	size_t      l = ::strlen( name );
+		if ( l >= sizeof( h ) ) {
+			::memcpy( &h, name, sizeof( h ) );
+			::memcpy( &t, name + l - sizeof( t ), sizeof( t ) );
+		} else {
+			::memcpy( &h, name, l );
+		}
+		*len = l;
+		h   ^= ( t * 0x9e3779b97f4a7c15ULL ) ^ l;
+		h    = ( h ^ ( h >> 33 ) ) * 0xff51afd7ed558ccdULL;
+		return (size_t)( h ^ ( h >> 33 ) );
+	}
+
+	static void *find(Slot *s, const char *name, size_t len, size_t gen)
+	{
+	size_t  seq = epicsAtomicGetSizeT( &s->seq );
+	void   *obj = 0;
+		if ( seq & 1 ) {
+			return 0;
+		}
+		epicsAtomicReadMemoryBarrier();
+		if ( s->gen == gen && 0 == ::memcmp( s->key, name, len + 1 ) ) {
+			obj = s->obj;
+		}
+		epicsAtomicReadMemoryBarrier();
+		return epicsAtomicGetSizeT( &s->seq ) == seq ? obj : 0;
+	}
+
+	/* Drops the update if another thread is writing the slot */
+	static void store(Slot *s, const char *name, size_t len, size_t gen, void *obj)
+	{
+	size_t  seq = epicsAtomicGetSizeT( &s->seq );
+		if ( ( seq & 1 ) || epicsAtomicCmpAndSwapSizeT( &s->seq, seq, seq + 1 ) != seq ) {
+			return;
+		}
+		epicsAtomicWriteMemoryBarrier();
+		s->gen = gen;
+		s->obj = obj;
+		::memcpy( s->key, name, len + 1 );
+		epicsAtomicWriteMemoryBarrier();
+		epicsAtomicSetSizeT( &s->seq, seq + 2 );
+	}
+
+public:
+	template <typename C> static C *lookup(const char *name)
+	{
+	size_t  len, gen;
+	Slot   *s;
+	C      *obj;
+
+		if ( ! name ) {
+			return m->at( name );
+		}
+		s = &slots_[ hash( name, &len ) & ( IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE - 1 ) ];
+		if ( len >= IOCSH_DECL_WRAPPER_OBJ_CACHE_KEYLEN ) {
+			return m->at( name );
+		}
+		/* read the generation before the map so that a concurrent change invalidates what we store */
+		gen = Generation::get( m );
+		if ( ( obj = static_cast<C*>( find( s, name, len, gen ) ) ) ) {
+			return obj;
+		}
+		obj = m->at( name );
+		if ( obj ) {
+			store( s, name, len, gen, obj );
+		}
+		return obj;
+	}
+};
+
+template <typename M, M m>
+typename ObjectCache<M, m, true>::Slot ObjectCache<M, m, true>::slots_[ IOCSH_DECL_WRAPPER_OBJ_CACHE_SIZE ];
+
+/* Hash of an object name (8 characters at a time) */
+struct ObjectNameHash {
+	static size_t hash(const char *name)
+	{
+	size_t      l = ::strlen( name );
+	size_t      i;
+	epicsUInt64 h = 0x9e3779b97f4a7c15ULL;
+	epicsUInt64 w;
+		for ( i = 0; i + sizeof( w ) <= l; i += sizeof( w ) ) {
+			::memcpy( &w, name + i, sizeof( w ) );
+			h  = ( h ^ w ) * 0xff51afd7ed558ccdULL;
+			h ^= h >> 29;
+		}
+		w = 0;
+		::memcpy( &w, name + i, l - i );
+		h  = ( h ^ w ^ ( (epicsUInt64)l << 56 ) ) * 0xc4ceb9fe1a85ec53ULL;
+		return (size_t)( h ^ ( h >> 32 ) );
+	}
+};
+
+/*
+ * Registry of named objects for IOCSH_MEMBER_WRAP (an alternative to
+ * std::map<const std::string, C*>). An open-addressing hash table (linear
+ * probing, backward-shift deletion) indexes entries by name; lookups take
+ * a 'const char *' and do not construct temporary strings. The registry
+ * keeps its own copy of every name, one allocation per entry (names are
+ * not interned across entries or registries); the pointer is stable while
+ * the object is registered. The registry does not own the objects.
+ *
+ * A Handle identifies an entry independent of table growth; get() returns
+ * NULL once the entry has been removed (even if the name is reused).
+ * Iteration visits the registered objects in unspecified order:
+ *
+ *   for ( auto &e : registry ) {
+ *     printf( "%s\n", e.name );
+ *   }
+ *
+ * Not thread-safe (like std::map).
+ */
+template <typename C> class ObjectRegistry {
+public:
+	struct Entry {
+		const char *name; /* NULL if the entry is free */
+		C          *obj;
+	};
+
+	class Handle {
+	public:
+		Handle()
+		: idx_( 0 ),
+		  serial_( 0 )
+		{
+		}
+
+		bool valid() const
+		{
+			return serial_ != 0;
+		}
+
+	private:
+		friend class ObjectRegistry;
+
+		Handle(size_t idx, size_t serial)
+		: idx_( idx ),
+		  serial_( serial )
+		{
+		}
+
+		size_t idx_;
+		size_t serial_;
+	};
+
+private:
+	struct Rec : public Entry {
+		size_t serial; /* 0 if the entry is free */
+	};
+
+	/* name and object are repeated here to save cache misses when probing */
+	struct Slot {
+		size_t      hash;
+		size_t      idx;  /* index into recs_ + 1; 0 if the slot is empty */
+		const char *name;
+		C          *obj;
+	};
+
+	std::vector<Rec>    recs_;
+	std::vector<size_t> free_;
+	std::vector<Slot>   table_;
+	size_t              size_;
+	size_t              serial_;
+
+	ObjectRegistry(const ObjectRegistry &);
+	ObjectRegistry &operator=(const ObjectRegistry &);
+
+	static size_t hash(const char *name)
+	{
+		return ObjectNameHash::hash( name );
+	}
+
+	/* Slot holding 'name' or the empty slot where it belongs */
+	size_t probe(const char *name, size_t h) const
+	{
+	size_t mask = table_.size() - 1;
+	size_t i;
+		for ( i = h & mask; table_[i].idx; i = ( i + 1 ) & mask ) {
+			if ( table_[i].hash == h && 0 == ::strcmp( table_[i].name, name ) ) {
+				break;
+			}
+		}
+		return i;
+	}
+
+	/* Empty slot if not found */
+	const Slot *lookup(const char *name) const
+	{
+	static const Slot none = Slot();
+		if ( ! name || ! size_ ) {
+			return &none;
+		}
+		return &table_[ probe( name, hash( name ) ) ];
+	}
+
+	/* The table is unchanged if the allocation fails */
+	void rehash(size_t cap)
+	{
+	std::vector<Slot> t( cap, Slot() );
+	size_t            i, j;
+		for ( i = 0; i < table_.size(); i++ ) {
+			if ( table_[i].idx ) {
+				for ( j = table_[i].hash & ( cap - 1 ); t[j].idx; j = ( j + 1 ) & ( cap - 1 ) )
+					;
+				t[j] = table_[i];
+			}
+		}
+		t.swap( table_ );
+	}
+
+	/* Close the gap at slot 'i' by moving back entries of the same probe sequence */
+	void erase(size_t i)
+	{
+	size_t mask = table_.size() - 1;
+	size_t j, k;
+		table_[i] = Slot();
+		for ( j = ( i + 1 ) & mask; table_[j].idx; j = ( j + 1 ) & mask ) {
+			k = table_[j].hash & mask;
+			/* leave it if its home slot lies cyclically in (i, j] */
+			if ( i <= j ? ( i < k && k <= j ) : ( i < k || k <= j ) ) {
+				continue;
+			}
+			table_[i] = table_[j];
+			table_[j] = Slot();
+			i         = j;
+		}
+	}
+
+	void release(size_t idx)
+	{
+	Rec *r = &recs_[ idx ];
+		delete [] r->name;
+		r->name   = 0;
+		r->obj    = 0;
+		r->serial = 0;
+		free_.push_back( idx );
+		size_--;
+	}
+
+public:
+	class Iterator {
+	public:
+		Iterator(const std::vector<Rec> *recs, size_t idx)
+		: recs_( recs ),
+		  idx_ ( idx  )
+		{
+			skip();
+		}
+
+		const Entry &operator*() const
+		{
+			return (*recs_)[ idx_ ];
+		}
+
+		const Entry *operator->() const
+		{
+			return &(*recs_)[ idx_ ];
+		}
+
+		Iterator &operator++()
+		{
+			idx_++;
+			skip();
+			return *this;
+		}
+
+		bool operator!=(const Iterator &o) const
+		{
+			return idx_ != o.idx_;
+		}
+
+		bool operator==(const Iterator &o) const
+		{
+			return idx_ == o.idx_;
+		}
+
+	private:
+		void skip()
+		{
+			while ( idx_ < recs_->size() && ! (*recs_)[ idx_ ].name ) {
+				idx_++;
+			}
+		}
+
+		const std::vector<Rec> *recs_;
+		size_t                  idx_;
+	};
+
+	ObjectRegistry()
+	: size_( 0 ),
+	  serial_( 0 )
+	{
+	}
+
+	~ObjectRegistry()
+	{
+		clear();
+	}
+
+	/*
+	 * Returns an invalid Handle if 'name' is NULL or already registered.
+	 * If an allocation fails (std::bad_alloc) the registry is unchanged.
+	 */
+	Handle add(const char *name, C *obj)
+	{
+	size_t  h, i, idx;
+	char   *nm;
+	Rec    *r;
+		if ( ! name ) {
+			return Handle();
+		}
+		/* keep the load factor <= 3/4 */
+		if ( 4 * ( size_ + 1 ) > 3 * table_.size() ) {
+			rehash( table_.size() ? 2 * table_.size() : 16 );
+		}
+		h = hash( name );
+		i = probe( name, h );
+		if ( table_[i].idx ) {
+			return Handle();
+		}
+		/* allocate first; neither taking a record nor release() may allocate */
+		if ( free_.empty() && recs_.size() == recs_.capacity() ) {
+			recs_.reserve( 2 * recs_.size() + 16 );
+		}
+		if ( free_.capacity() < recs_.capacity() ) {
+			free_.reserve( recs_.capacity() );
+		}
+		nm = ::strcpy( new char[ ::strlen( name ) + 1 ], name );
+		if ( free_.size() ) {
+			idx = free_.back();
+			free_.pop_back();
+		} else {
+			idx = recs_.size();
+			recs_.push_back( Rec() );
+		}
+		r         = &recs_[ idx ];
+		r->name   = nm;
+		r->obj    = obj;
+		r->serial = ++serial_;
+		table_[i].hash = h;
+		table_[i].idx  = idx + 1;
+		table_[i].name = r->name;
+		table_[i].obj  = obj;
+		size_++;
+		return Handle( idx, r->serial );
+	}
+
+	/* Returns false if 'name' is not registered */
+	bool remove(const char *name)
+	{
+	size_t i;
+		if ( ! name || ! size_ || ! table_[ i = probe( name, hash( name ) ) ].idx ) {
+			return false;
+		}
+		release( table_[i].idx - 1 );
+		erase( i );
+		return true;
+	}
+
+	bool remove(Handle h)
+	{
+		return live( h ) && remove( recs_[ h.idx_ ].name );
+	}
+
+	void clear()
+	{
+	size_t i;
+		for ( i = 0; i < recs_.size(); i++ ) {
+			delete [] recs_[i].name;
+		}
+		recs_.clear();
+		free_.clear();
+		table_.clear();
+		size_ = 0;
+	}
+
+	/* Returns NULL if 'name' is not registered */
+	C *find(const char *name) const
+	{
+		return lookup( name )->obj;
+	}
+
+	/* The contract required by IOCSH_MEMBER_WRAP; throws std::out_of_range if 'name' is not registered */
+	C *at(const char *name) const
+	{
+	const Slot *s = lookup( name );
+		if ( ! s->idx ) {
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			throw std::out_of_range( std::string( "Object '" ) + ( name ? name : "<NULL>" ) + "' not found" );
+#else
+			::abort();
+#endif
+		}
+		return s->obj;
+	}
+
+	C *at(const std::string &name) const
+	{
+		return at( name.c_str() );
+	}
+
+	/* Returns an invalid Handle if 'name' is not registered */
+	Handle handle(const char *name) const
+	{
+	size_t idx = lookup( name )->idx;
+		return idx ? Handle( idx - 1, recs_[ idx - 1 ].serial ) : Handle();
+	}
+
+	/* Is the entry still registered? */
+	bool live(Handle h) const
+	{
+		return h.valid() && h.idx_ < recs_.size() && recs_[ h.idx_ ].serial == h.serial_;
+	}
+
+	/* Returns NULL if the entry has been removed */
+	C *get(Handle h) const
+	{
+		return live( h ) ? recs_[ h.idx_ ].obj : 0;
+	}
+
+	/* Returns NULL if the entry has been removed */
+	const char *name(Handle h) const
+	{
+		return live( h ) ? recs_[ h.idx_ ].name : 0;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	Iterator begin() const
+	{
+		return Iterator( &recs_, 0 );
+	}
+
+	Iterator end() const
+	{
+		return Iterator( &recs_, recs_.size() );
+	}
+};
+
+/*
+ * Registry of named objects which may be modified while member wrappers
+ * are executing (e.g., objects created or destroyed by driver threads
+ * after iocInit).
+ *
+ * Readers (the member wrappers; see MapReadGuard) enter a read section,
+ * look the object up and call the member; they never lock or retry.
+ * Writers are serialized by a mutex. Objects are added in place to an
+ * open-addressing table; removed entries are marked (tombstones) and the
+ * table is rebuilt (copied) when it fills up. Removal, replacement and
+ * rebuilding wait for all read sections that might still use the old
+ * entry or table (like RCU): once remove() or replace() return, no member
+ * call on the old object is in progress and the object may be deleted.
+ * Consequently these must not be called from within a member function
+ * invoked through this registry.
+ *
+ * find() and at() are safe only inside a ReadGuard (as the wrappers use
+ * them) or if the caller otherwise knows that the object is not removed.
+ */
+template <typename C> class ConcurrentObjectRegistry {
+public:
+	/* Read-side critical section */
+	class ReadGuard {
+	public:
+		ReadGuard(const ConcurrentObjectRegistry *r)
+		: r_  ( const_cast<ConcurrentObjectRegistry*>( r ) ),
+		  idx_( r_->enter() )
+		{
+		}
+
+		~ReadGuard()
+		{
+			r_->leave( idx_ );
+		}
+
+	private:
+		ReadGuard(const ReadGuard &);
+		ReadGuard &operator=(const ReadGuard &);
+
+		ConcurrentObjectRegistry *r_;
+		size_t                    idx_;
+	};
+
+private:
+	/* Writer mutex; released on exit even if allocating a table or name throws */
+	class WriteGuard {
+	public:
+		WriteGuard(epicsMutexId mtx)
+		: mtx_( mtx )
+		{
+			epicsMutexMustLock( mtx_ );
+		}
+
+		~WriteGuard()
+		{
+			epicsMutexUnlock( mtx_ );
+		}
+
+	private:
+		WriteGuard(const WriteGuard &);
+		WriteGuard &operator=(const WriteGuard &);
+
+		epicsMutexId mtx_;
+	};
+
+private:
+	struct Slot {
+		const char *name; /* NULL if empty, &tomb_ if removed; published last */
+		size_t      hash;
+		C          *obj;
+	};
+
+	struct Table {
+		size_t            used;  /* live entries and tombstones */
+		std::vector<Slot> slots;
+
+		Table(size_t cap)
+		: used ( 0 ),
+		  slots( cap, Slot() )
+		{
+		}
+	};
+
+	static char  tomb_;
+
+	Table       *table_;
+	size_t       size_;
+	size_t       epoch_;
+	size_t       readers_[2];
+	size_t       waiting_; /* 1 + index of the readers_ the writer waits for; 0 if none */
+	epicsEventId drained_; /* signalled when the last of these readers leaves */
+	epicsMutexId mtx_;
+
+	ConcurrentObjectRegistry(const ConcurrentObjectRegistry &);
+	ConcurrentObjectRegistry &operator=(const ConcurrentObjectRegistry &);
+
+	size_t enter()
+	{
+	size_t idx = epicsAtomicGetSizeT( &epoch_ ) & 1;
+		epicsAtomicIncrSizeT( &readers_[ idx ] );
+		return idx;
+	}
+
+	void leave(size_t idx)
+	{
+		if ( 0 == epicsAtomicDecrSizeT( &readers_[ idx ] ) && idx + 1 == epicsAtomicGetSizeT( &waiting_ ) ) {
+			epicsEventSignal( drained_ );
+		}
+	}
+
+	/*
+	 * Wait for all read sections entered before the call; writer mutex held.
+	 * The writer blocks (read sections may be long, e.g., a member call
+	 * doing I/O) until the last reader of the old epoch leaves. Announcing
+	 * the wait is a read-modify-write (full barrier) just like the reader's
+	 * decrement: either that reader sees 'waiting_' or we see its count
+	 * drop to zero. A stale signal merely causes another check.
+	 */
+	void synchronize()
+	{
+	size_t i, idx;
+		epicsAtomicWriteMemoryBarrier();
+		/* two phases: a reader may have sampled the epoch just before it changed */
+		for ( i = 0; i < 2; i++ ) {
+			idx = epicsAtomicGetSizeT( &epoch_ ) & 1;
+			epicsAtomicIncrSizeT( &epoch_ );
+			epicsAtomicCmpAndSwapSizeT( &waiting_, 0, idx + 1 );
+			while ( epicsAtomicGetSizeT( &readers_[ idx ] ) ) {
+				epicsEventMustWait( drained_ );
+			}
+			epicsAtomicSetSizeT( &waiting_, 0 );
+		}
+	}
+
+	static const char *slotName(const Slot *s)
+	{
+	const char *n = (const char *)epicsAtomicGetPtrT( (EpicsAtomicPtrT*)&s->name );
+		epicsAtomicReadMemoryBarrier();
+		return n;
+	}
+
+	/* Live slot holding 'name'; NULL if not found */
+	static const Slot *probe(const Table *t, const char *name, size_t h)
+	{
+	size_t      mask = t->slots.size() - 1;
+	size_t      i;
+	const char *n;
+		for ( i = h & mask; ( n = slotName( &t->slots[i] ) ); i = ( i + 1 ) & mask ) {
+			if ( n != &tomb_ && t->slots[i].hash == h && 0 == ::strcmp( n, name ) ) {
+				return &t->slots[i];
+			}
+		}
+		return 0;
+	}
+
+	const Slot *lookup(const char *name) const
+	{
+	const Table *t = (const Table *)epicsAtomicGetPtrT( (EpicsAtomicPtrT*)&table_ );
+		epicsAtomicReadMemoryBarrier();
+		return name && t ? probe( t, name, ObjectNameHash::hash( name ) ) : 0;
+	}
+
+	/* Publish an entry in an empty slot; writer mutex held */
+	static void insert(Table *t, const char *name, size_t h, C *obj)
+	{
+	size_t mask = t->slots.size() - 1;
+	size_t i;
+	Slot  *s;
+		for ( i = h & mask; t->slots[i].name; i = ( i + 1 ) & mask )
+			;
+		s       = &t->slots[i];
+		s->hash = h;
+		s->obj  = obj;
+		epicsAtomicWriteMemoryBarrier();
+		epicsAtomicSetPtrT( (EpicsAtomicPtrT*)&s->name, (EpicsAtomicPtrT)name );
+		t->used++;
+	}
+
+	/* Make room for one more entry, rebuilding the table without tombstones if necessary; writer mutex held */
+	void reserve()
+	{
+	Table  *old = table_;
+	Table  *t;
+	size_t  cap, i;
+		if ( old && 4 * ( old->used + 1 ) <= 3 * old->slots.size() ) {
+			return;
+		}
+		for ( cap = 16; 2 * ( size_ + 1 ) > cap; cap *= 2 )
+			;
+		t = new Table( cap );
+		if ( old ) {
+			for ( i = 0; i < old->slots.size(); i++ ) {
+				const Slot *s = &old->slots[i];
+				if ( s->name && s->name != &tomb_ ) {
+					insert( t, s->name, s->hash, s->obj );
+				}
+			}
+		}
+		epicsAtomicWriteMemoryBarrier();
+		epicsAtomicSetPtrT( (EpicsAtomicPtrT*)&table_, (EpicsAtomicPtrT)t );
+		if ( old ) {
+			synchronize();
+			delete old;
+		}
+	}
+
+	/* Remove the entry in slot 's' and wait until it is no longer used; writer mutex held */
+	void retire(const Slot *s)
+	{
+		epicsAtomicSetPtrT( (EpicsAtomicPtrT*)&s->name, (EpicsAtomicPtrT)&tomb_ );
+		synchronize();
+	}
+
+public:
+	ConcurrentObjectRegistry()
+	: table_  ( 0 ),
+	  size_   ( 0 ),
+	  epoch_  ( 0 ),
+	  waiting_( 0 ),
+	  drained_( epicsEventMustCreate( epicsEventEmpty ) ),
+	  mtx_    ( epicsMutexMustCreate() )
+	{
+		readers_[0] = readers_[1] = 0;
+	}
+
+	/* There must be no readers left */
+	~ConcurrentObjectRegistry()
+	{
+	size_t i;
+		if ( table_ ) {
+			for ( i = 0; i < table_->slots.size(); i++ ) {
+				if ( table_->slots[i].name != &tomb_ ) {
+					delete [] table_->slots[i].name;
+				}
+			}
+			delete table_;
+		}
+		epicsEventDestroy( drained_ );
+		epicsMutexDestroy( mtx_ );
+	}
+
+	/* Returns false if 'name' is NULL or already registered */
+	bool add(const char *name, C *obj)
+	{
+		if ( ! name ) {
+			return false;
+		}
+		WriteGuard guard( mtx_ );
+		if ( lookup( name ) ) {
+			return false;
+		}
+		reserve();
+		insert( table_, ::strcpy( new char[ ::strlen( name ) + 1 ], name ), ObjectNameHash::hash( name ), obj );
+		epicsAtomicIncrSizeT( &size_ );
+		return true;
+	}
+
+	/* Returns false if 'name' is not registered; blocks until no member call on the object is in progress */
+	bool remove(const char *name)
+	{
+	const Slot *s;
+	const char *n = 0;
+		{
+		WriteGuard guard( mtx_ );
+			if ( ( s = lookup( name ) ) ) {
+				n = s->name;
+				retire( s );
+				epicsAtomicDecrSizeT( &size_ );
+			}
+		}
+		delete [] n;
+		return !! s;
+	}
+
+	/*
+	 * Atomically replace the object registered as 'name'; calls find either
+	 * object. Returns the old object (NULL if 'name' is not registered; nothing
+	 * is changed in this case) once no member call on it is in progress.
+	 */
+	C *replace(const char *name, C *obj)
+	{
+	WriteGuard  guard( mtx_ );
+	const Slot *s = lookup( name );
+	C          *old;
+		if ( ! s ) {
+			return 0;
+		}
+		old = s->obj;
+		reserve();
+		/* the table may have been rebuilt */
+		s   = lookup( name );
+		/* the new entry follows the old one in the probe sequence */
+		insert( table_, s->name, s->hash, obj );
+		retire( s );
+		return old;
+	}
+
+	/* Returns NULL if 'name' is not registered */
+	C *find(const char *name) const
+	{
+	const Slot *s = lookup( name );
+		return s ? s->obj : 0;
+	}
+
+	/* The contract required by IOCSH_MEMBER_WRAP; throws std::out_of_range if 'name' is not registered */
+	C *at(const char *name) const
+	{
+	const Slot *s = lookup( name );
+		if ( ! s ) {
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			throw std::out_of_range( std::string( "Object '" ) + ( name ? name : "<NULL>" ) + "' not found" );
+#else
+			::abort();
+#endif
+		}
+		return s->obj;
+	}
+
+	C *at(const std::string &name) const
+	{
+		return at( name.c_str() );
+	}
+
+	/* Call f( const char *name, C *obj ) for every object (in unspecified order) inside a read section */
+	template <typename F> void forEach(F f) const
+	{
+	ReadGuard    guard( this );
+	const Table *t = (const Table *)epicsAtomicGetPtrT( (EpicsAtomicPtrT*)&table_ );
+	const char  *n;
+	size_t       i;
+		epicsAtomicReadMemoryBarrier();
+		for ( i = 0; t && i < t->slots.size(); i++ ) {
+			if ( ( n = slotName( &t->slots[i] ) ) && n != &tomb_ ) {
+				f( n, t->slots[i].obj );
+			}
+		}
+	}
+
+	size_t size() const
+	{
+		return epicsAtomicGetSizeT( &size_ );
+	}
+};
+
+template <typename C> char ConcurrentObjectRegistry<C>::tomb_;
+
+/*
+ * Read-side critical section around the object lookup and the member call
+ * of a member wrapper. Nothing by default; the ConcurrentObjectRegistry
+ * uses it to defer removal of objects until calls on them have completed.
+ */
+template <typename M, int USER = 0> struct MapReadGuard {
+	MapReadGuard(const M *m)
+	{
+	}
+};
+
+template <typename C> struct MapReadGuard< ConcurrentObjectRegistry<C> > : public ConcurrentObjectRegistry<C>::ReadGuard {
+	MapReadGuard(const ConcurrentObjectRegistry<C> *m)
+	: ConcurrentObjectRegistry<C>::ReadGuard( m )
+	{
+	}
+};
+
+/*
+ * Enumerate the objects of a map for a broadcast member call (see
+ * MemberTypeHelper::broadcast): calls f( const char *name, C *obj )
+ * for every object. The default handles std::map-like containers
+ * keyed by std::string or const char *. Called within a MapReadGuard.
+ */
+template <typename M, int USER = 0> struct MapForEach {
+	static const char *keyName(const std::string &k)
+	{
+		return k.c_str();
+	}
+
+	static const char *keyName(const char *k)
+	{
+		return k;
+	}
+
+	template <typename F> static void visit(const M *m, F &f)
+	{
+		for ( typename M::const_iterator it = m->begin(); it != m->end(); ++it ) {
+			f( keyName( it->first ), it->second );
+		}
+	}
+};
+
+template <typename C> struct MapForEach< ObjectRegistry<C> > {
+	template <typename F> static void visit(const ObjectRegistry<C> *m, F &f)
+	{
+		for ( typename ObjectRegistry<C>::Iterator it = m->begin(); it != m->end(); ++it ) {
+			f( (*it).name, (*it).obj );
+		}
+	}
+};
+
+template <typename C> struct MapForEach< ConcurrentObjectRegistry<C> > {
+	template <typename F> static void visit(const ConcurrentObjectRegistry<C> *m, F &f)
+	{
+		/* forEach() enters a (nested) read section */
+		m->template forEach<F &>( f );
+	}
+};
+
+/*
+ * Is the 'objName' argument of a member wrapper a glob pattern?
+ */
+inline bool isObjectPattern(const char *objName)
+{
+	return objName && ::strpbrk( objName, "*?" );
+}
+
+/*
+ * How a broadcast keeps the result of a member call until the table is
+ * printed: by value, references as pointers; nothing for 'void'.
+ */
+template <typename R> struct BroadcastValue {
+	typedef typename std::remove_const<R>::type type;
+
+	static const type &put(const type &v)
+	{
+		return v;
+	}
+
+	template <typename P> static void print(PrintBuffer &out, P pri, const type &v)
+	{
+		pri( out, v );
+	}
+};
+
+template <typename R> struct BroadcastValue<R &> {
+	typedef R *type;
+
+	static type put(const R &v)
+	{
+		return const_cast<R *>( &v );
+	}
+
+	template <typename P> static void print(PrintBuffer &out, P pri, type v)
+	{
+		pri( out, *v );
+	}
+};
+
+template <> struct BroadcastValue<void> {
+	typedef char type;
+
+	template <typename P> static void print(PrintBuffer &out, P pri, type v)
+	{
+		out.append( "OK\n" );
+	}
+};
+
+/* Stores a result by means of the 'operator,' trick (see EvalResult) */
+template <typename R> class BroadcastCollect {
+private:
+	std::vector<typename BroadcastValue<R>::type> *vals_;
+public:
+	BroadcastCollect(std::vector<typename BroadcastValue<R>::type> *vals)
+	: vals_( vals )
+	{
+	}
+
+	void operator,(typename Reference<R>::const_type result)
+	{
+		vals_->push_back( BroadcastValue<R>::put( result ) );
+	}
+};
+
+template <> class BroadcastCollect<void> {
+public:
+	BroadcastCollect(std::vector<char> *vals)
+	{
+	}
+
+	/* Use the built-in 'operator,' */
+};
+
+/*
+ * Results of a member call broadcast to all objects matching a glob
+ * pattern (see MemberTypeHelper::broadcast): one row per object in
+ * the order the calls were made. The results are formatted (by the
+ * printer of the member wrapper) only when the table is printed.
+ */
+template <typename R> struct BroadcastTable {
+	typedef typename EvalResult<R>::PrinterType PrinterType;
+	typedef typename BroadcastValue<R>::type    Value;
+
+	struct Row {
+		size_t      name;  /* offset into 'names'                 */
+		size_t      val;   /* index into 'vals' unless 'failed'   */
+		bool        failed;
+		std::string error;
+	};
+
+	std::string        pattern;
+	std::string        names;   /* NUL-terminated names of all rows */
+	std::vector<Row>   rows;
+	std::vector<Value> vals;
+	PrinterType        printer;
+	size_t             failed;
+
+	BroadcastTable()
+	: printer( 0 ),
+	  failed ( 0 )
+	{
+	}
+
+	const char *name(const Row &r) const
+	{
+		return names.c_str() + r.name;
+	}
+
+	/* Append the rows of another table (with the same printer) */
+	void append(const BroadcastTable &o)
+	{
+	size_t nameOff = names.size();
+	size_t valOff  = vals.size();
+	size_t i;
+		names.append( o.names );
+		vals.insert( vals.end(), o.vals.begin(), o.vals.end() );
+		for ( i = 0; i < o.rows.size(); i++ ) {
+			rows.push_back( o.rows[i] );
+			rows.back().name += nameOff;
+			rows.back().val  += valOff;
+		}
+		failed += o.failed;
+	}
+
+	/* Orders row indices by object name */
+	struct ByName {
+		const BroadcastTable *t;
+
+		ByName(const BroadcastTable *t)
+		: t( t )
+		{
+		}
+
+		bool operator()(size_t a, size_t b) const
+		{
+			return ::strcmp( t->name( t->rows[a] ), t->name( t->rows[b] ) ) < 0;
+		}
+	};
+};
+
+/*
+ * Print a BroadcastTable (sorted by object name) as
+ *
+ *   object   result
+ *   ch1      42 (0x0000002a)
+ *   ch2      Error: Exception -- bus timeout
+ *   2 objects, 1 failed
+ *
+ * Members returning 'void' show 'OK'; results spanning several lines
+ * are indented to the result column.
+ */
+template <typename R, int USER> class PrinterBase< BroadcastTable<R>, BroadcastTable<R>, USER > {
+public:
+	static void print( PrintBuffer &out, const BroadcastTable<R> &t )
+	{
+	PrintBuffer         txt;
+	std::vector<size_t> order( t.rows.size() );
+	size_t              w = 6;
+	size_t              i, l;
+		if ( t.rows.empty() ) {
+			out.append( "No object matches '%s'\n", t.pattern.c_str() );
+			return;
+		}
+		for ( i = 0; i < t.rows.size(); i++ ) {
+			order[i] = i;
+			if ( ( l = ::strlen( t.name( t.rows[i] ) ) ) > w ) {
+				w = l;
+			}
+		}
+		std::sort( order.begin(), order.end(), typename BroadcastTable<R>::ByName( &t ) );
+		out.append( "%-*s  result\n", (int)w, "object" );
+		for ( i = 0; i < order.size(); i++ ) {
+			const typename BroadcastTable<R>::Row &row = t.rows[ order[i] ];
+			const char                            *s, *e;
+			if ( row.failed ) {
+				txt.append( "Error: %s\n", row.error.c_str() );
+			} else {
+				BroadcastValue<R>::print( txt, t.printer, t.vals[ row.val ] );
+			}
+			out.append( "%-*s  ", (int)w, t.name( row ) );
+			for ( s = txt.str(); *s; s = *e ? e + 1 : e ) {
+				if ( s != txt.str() ) {
+					out.append( "%-*s  ", (int)w, "" );
+				}
+				if ( ! ( e = ::strchr( s, '\n' ) ) ) {
+					e = s + ::strlen( s );
+				}
+				out.write( s, e - s );
+				out.append( "\n" );
+			}
+			if ( ! *txt.str() ) {
+				out.append( "\n" );
+			}
+			txt.clear();
+		}
+		out.append( "%lu object%s, %lu failed\n", (unsigned long)t.rows.size(), t.rows.size() == 1 ? "" : "s", (unsigned long)t.failed );
+	}
+
+	static void print( const BroadcastTable<R> &t )
+	{
+		PrintBuffer out;
+		print( out, t );
+	}
+};
+
+#if IOCSH_DECL_WRAPPER_PARALLEL
+#ifndef IOCSH_DECL_WRAPPER_PARALLEL_THREADS
+#define IOCSH_DECL_WRAPPER_PARALLEL_THREADS 32 /* max. worker threads of the pool  */
+#endif
+#ifndef IOCSH_DECL_WRAPPER_PARALLEL_MAX
+#define IOCSH_DECL_WRAPPER_PARALLEL_MAX     8  /* default of 'iocshWrapParallelMax' */
+#endif
+
+/* Max. number of concurrent calls of a parallel broadcast; exported as an iocsh variable */
+template <int USER = 0> struct ParallelMax {
+	static int value;
+};
+
+template <int USER> int ParallelMax<USER>::value = IOCSH_DECL_WRAPPER_PARALLEL_MAX;
+
+/*
+ * The worker threads shared by all parallel broadcasts. The pool is
+ * created when the first parallel wrapper is registered; its threads
+ * are started on demand (up to IOCSH_DECL_WRAPPER_PARALLEL_THREADS).
+ * The number of calls a broadcast runs concurrently (the calling
+ * thread included) is limited by the iocsh variable 'iocshWrapParallelMax'
+ * (values < 2 run the calls sequentially).
+ */
+class ParallelPool {
+private:
+	epicsMutexId              mtx_;
+	epicsThreadPool          *pool_;
+	std::vector<epicsEventId> events_;
+
+	ParallelPool()
+	: mtx_ ( epicsMutexMustCreate() ),
+	  pool_( 0 )
+	{
+	static const iocshVarDef  vars[] = {
+		{ "iocshWrapParallelMax", iocshArgInt, (void*)&ParallelMax<0>::value },
+		{ 0,                      iocshArgInt, 0                             }
+	};
+	epicsThreadPoolConfig     cfg;
+
+		epicsThreadPoolConfigDefaults( &cfg );
+		cfg.initialThreads = 0;
+		cfg.maxThreads     = IOCSH_DECL_WRAPPER_PARALLEL_THREADS;
+		if ( ! (pool_ = epicsThreadPoolCreate( &cfg )) ) {
+			errlogPrintf( "iocshDeclWrapper: unable to create thread pool; broadcasts are sequential\n" );
+		}
+		iocshRegisterVariable( vars );
+	}
+
+	ParallelPool(const ParallelPool &);
+	ParallelPool & operator=(const ParallelPool &);
+
+	static ParallelPool *get()
+	{
+	static ParallelPool thePool;
+		return &thePool;
+	}
+
+public:
+	/* Create the pool and register the iocsh variable (once) */
+	static void init()
+	{
+		get();
+	}
+
+	static epicsThreadPool *pool()
+	{
+		return get()->pool_;
+	}
+
+	/* Number of concurrent calls for a broadcast to 'nobjs' objects */
+	static size_t concurrency(size_t nobjs)
+	{
+	int    lim = ParallelMax<0>::value;
+	size_t n   = lim < 1 ? 1 : (size_t)lim;
+		if ( n > IOCSH_DECL_WRAPPER_PARALLEL_THREADS + 1 ) {
+			n = IOCSH_DECL_WRAPPER_PARALLEL_THREADS + 1;
+		}
+		return n < nobjs ? n : nobjs;
+	}
+
+	/*
+	 * Events signalling the completion of a broadcast are recycled, never
+	 * destroyed: the last worker may still be inside epicsEventSignal()
+	 * when the waiting thread proceeds.
+	 */
+	static epicsEventId getEvent()
+	{
+	ParallelPool *p  = get();
+	epicsEventId  ev = 0;
+		epicsMutexMustLock( p->mtx_ );
+		if ( ! p->events_.empty() ) {
+			ev = p->events_.back();
+			p->events_.pop_back();
+		}
+		epicsMutexUnlock( p->mtx_ );
+		return ev ? ev : epicsEventMustCreate( epicsEventEmpty );
+	}
+
+	static void putEvent(epicsEventId ev)
+	{
+	ParallelPool *p = get();
+		epicsMutexMustLock( p->mtx_ );
+		p->events_.push_back( ev );
+		epicsMutexUnlock( p->mtx_ );
+	}
+};
+
+/*
+ * The arguments of a parallel broadcast are shared by all calls; they
+ * must not be passed by non-const reference.
+ */
+template <typename T> struct SharedArg {
+	static const bool value = true;
+};
+
+template <typename T> struct SharedArg<T &> {
+	static const bool value = std::is_const<T>::value;
+};
+
+template <typename T> struct SharedArg<T &&> {
+	static const bool value = false;
+};
+
+template <typename ...A> struct SharedArgs {
+	static const bool value = true;
+};
+
+template <typename H, typename ...T> struct SharedArgs<H, T...> {
+	static const bool value = SharedArg<H>::value && SharedArgs<T...>::value;
+};
+
+/* Runs the calls of a parallel broadcast (defined below) */
+template <typename R, typename C, typename ...A> class ParallelBroadcast;
+#endif
+
+/* A special trick to let the user specify overloaded functions. We want to do this
+ * with a final macro:
+ *   #define _WRAP( fun, overload_args, name, help... )
+ * Because the pre-processor requires parentheses around anything containing commas
+ * the macro must be expanded like this:
+ *
+ *   _WRAP( myFunc, (int, char*), "myFunc_1" )
+ *
+ * The following templates allow us to get rid of the parentheses and use the type
+ * signatures...
+ */
+template <typename T> struct DropBraces;
+
+/* First the specialization for T=void which auto-derives the types; this is used
+ * when a function is not overloaded
+ */
+template <> struct DropBraces<void> {
+
+	template <typename R, typename ...A> struct TypeHelper {
+		typedef R (FuncType)(A...);
+		typedef IocshDeclWrapper::FuncDefStorage< sizeof...(A) > FuncDefStorage;
+		/* Is the function declared 'noexcept'? */
+		static const bool nothrow = false;
+	};
+
+#if __cplusplus >= 201703L
+	/* 'noexcept' is part of the function type */
+	template <bool NX, typename R, typename ...A> struct NoThrowTypeHelper : public TypeHelper<R, A...> {
+		static const bool nothrow = NX;
+	};
+
+	template <typename R, typename ...A, bool NX>
+	static NoThrowTypeHelper<NX,R,A...> type(R (*f)(A...) noexcept(NX))
+	{
+		return NoThrowTypeHelper<NX,R,A...>();
+	}
+#else
+	template <typename R, typename ...A>
+	static TypeHelper<R,A...> type(R (*f)(A...))
+	{
+		return TypeHelper<R,A...>();
+	}
+#endif
+
+	template <typename R, typename C, typename ...A>
+	struct MemberTypeHelper {
+		typedef R (C::*MemberFuncType)(A...);
 
 		template <typename T> struct IDENT {
 			typedef T type;
 		};
 
-		template <R (C::*f)(A...), class M, IDENT<M>::type m >
+		template <R (C::*f)(A...), class M, typename IDENT<M>::type m >
 		static R wrapper(const char *name, A...args)
 		{
-			C *obj = m->at(name);
+			MapReadGuard<typename std::remove_pointer<M>::type> guard( m );
+			C *obj = ObjectCache<M, m>::template lookup<C>( name );
 			return ((*obj).*f)(args...);
 		}
 
+		typedef std::pair<const char *, C *> Match;
+
+		/* Collects the objects whose name matches a glob pattern (see MapForEach) */
+		struct Matches {
+			const char         *pattern;
+			std::vector<Match>  objs;
+
+			Matches(const char *pattern)
+			: pattern( pattern )
+			{
+			}
+
+			void operator()(const char *name, C *obj)
+			{
+				if ( epicsStrGlobMatch( name, pattern ) ) {
+					objs.push_back( Match( name, obj ) );
+				}
+			}
+		};
+
+		/* Call the member on one object and record the result (or the error) in 'tbl' */
+		template <R (C::*f)(A...), typename ...P>
+		static void record(BroadcastTable<R> *tbl, const Match &target, P &...args)
+		{
+			typedef typename BroadcastTable<R>::Row Row;
+			tbl->rows.push_back( Row() );
+			Row &row   = tbl->rows.back();
+			row.name   = tbl->names.size();
+			row.val    = tbl->vals.size();
+			row.failed = false;
+			tbl->names.append( target.first, ::strlen( target.first ) + 1 );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			try {
+#endif
+				( BroadcastCollect<R>( &tbl->vals ), ((*target.second).*f)(args...) );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			} catch ( std::exception &e ) {
+				row.failed = true;
+				row.error  = std::string( "Exception -- " ) + e.what();
+			} catch ( ... ) {
+				row.failed = true;
+				row.error  = "Unknown Exception";
+			}
+			if ( row.failed ) {
+				tbl->failed++;
+			}
+#endif
+		}
+
+		/* Objects matching the pattern 'name'; the table is prepared for them */
+		template <R (C::*f)(A...), class M, typename IDENT<M>::type m >
+		static void match(Matches *matches, BroadcastTable<R> *tbl, const char *name)
+		{
+			MapForEach<typename std::remove_pointer<M>::type>::visit( m, *matches );
+			tbl->pattern = name ? name : "";
+			tbl->printer = Guesser<R, R(const char *, A...)>::template getPrinter< &wrapper<f, M, m> >();
+			tbl->rows.reserve( matches->objs.size() );
+			tbl->vals.reserve( matches->objs.size() );
+		}
+
+		/*
+		 * 'name' is a glob pattern: call the member on all matching objects
+		 * (in the order MapForEach visits them, which is unspecified for
+		 * the registries) with the same arguments, which have been converted
+		 * only once. The results are collected in a table which is printed
+		 * sorted by object name; an exception thrown by one object is
+		 * recorded in its row and does not affect the others.
+		 */
+		template <R (C::*f)(A...), class M, typename IDENT<M>::type m >
+		static BroadcastTable<R> broadcast(const char *name, A...args)
+		{
+			MapReadGuard<typename std::remove_pointer<M>::type> guard( m );
+			Matches                                             matches( name );
+			BroadcastTable<R>                                   tbl;
+			size_t                                              i;
+
+			match<f, M, m>( &matches, &tbl, name );
+			for ( i = 0; i < matches.objs.size(); i++ ) {
+				record<f>( &tbl, matches.objs[i], args... );
+			}
+			return tbl;
+		}
+
+#if IOCSH_DECL_WRAPPER_PARALLEL
+		/*
+		 * As 'broadcast' but the calls are distributed over the threads of
+		 * the ParallelPool (the calling thread takes part). The arguments
+		 * are shared (read-only) by all calls. Returns when all calls have
+		 * completed.
+		 */
+		template <R (C::*f)(A...), class M, typename IDENT<M>::type m >
+		static BroadcastTable<R> broadcastParallel(const char *name, A...args)
+		{
+			static_assert( SharedArgs<A...>::value, "parallel broadcast: member must not take non-const reference arguments" );
+			MapReadGuard<typename std::remove_pointer<M>::type> guard( m );
+			Matches                                             matches( name );
+			BroadcastTable<R>                                   tbl;
+
+			match<f, M, m>( &matches, &tbl, name );
+			ParallelBroadcast<R, C, A...>::template run<f>( &tbl, matches.objs, args... );
+			return tbl;
+		}
+#endif
+
 		template <R (C::*f)(A...)>
 		static R wrappert(const char *name, A...args)
 		{
@@ -1200,146 +5160,500 @@ template <> struct DropBraces<void> {
 	static MemberTypeHelper<R, C, A...>
 	memberType(R (C::*f)(A...))
 	{
-		return MemberTypeHelper<R, C, A...>();
+		return MemberTypeHelper<R, C, A...>();
+	}
+
+	/*
+	 * Populate a (static) iocshFuncDef with associated iocArg structs.
+	 * Since we wrap huge masses of user functions the iocArgs
+	 * are shared (same epics type, same help string) by means
+	 * of the ArgCache.
+	 */
+	template <typename R, typename ...A>
+	static iocshFuncDef  *buildArgs( FuncDefStorage<sizeof...(A)> *storage, const char *fname, R (*f)(A...), std::initializer_list<const char *> argNames )
+	{
+		std::initializer_list<const char*>::const_iterator it;
+		iocshFuncDef *def = storage->init( fname );
+		int           i   = 0;
+		iocshArg      args[ sizeof...(A) + 1 ];
+		// use array initializer to ensure order of execution
+		int           dummy[] = { 0, (makeArg<A>( &args[i++] ), 0)... };
+
+		(void)dummy;
+		it              = argNames.begin();
+		for ( i = 0; i < (int)sizeof...(A); i++ ) {
+			if ( it != argNames.end() ) {
+				if (*it) {
+					args[i].name = *it;
+				}
+				++it;
+			}
+			storage->setArg( i, &args[i] );
+		}
+		return def;
+	}
+};
+
+/* Specialization used when we are given an explicit signature
+ */
+template <typename T, typename ...SIG> struct DropBraces<T(SIG...)> {
+
+#if __cplusplus >= 201703L
+	template <typename R, bool NX>
+	static DropBraces<void>::NoThrowTypeHelper<NX,R,SIG...> type(R (*f)(SIG...) noexcept(NX))
+	{
+		return DropBraces<void>::NoThrowTypeHelper<NX, R, SIG...>();
+	}
+#else
+	template <typename R>
+	static DropBraces<void>::TypeHelper<R,SIG...> type(R (*f)(SIG...))
+	{
+		return DropBraces<void>::TypeHelper<R, SIG...>();
+	}
+#endif
+
+	template <typename R, typename C>
+	static DropBraces<void>::MemberTypeHelper<R,C,SIG...> memberType(R (C::*f)(SIG...))
+	{
+		return DropBraces<void>::MemberTypeHelper<R, C, SIG...>();
+	}
+
+
+	template <typename R>
+	static iocshFuncDef  *buildArgs( FuncDefStorage<sizeof...(SIG)> *storage, const char *fname, R (*f)(SIG...), std::initializer_list<const char *> argNames )
+	{
+		return DropBraces<void>::buildArgs<R, SIG...>( storage, fname, f, argNames );
+	}
+};
+
+/*
+ * Sum of the arena space required for converting arguments A...
+ */
+template <typename ...A> struct ContextSizeSum;
+
+template <> struct ContextSizeSum<> {
+	static const size_t value = 0;
+};
+
+template <typename H, typename ...T> struct ContextSizeSum<H, T...> {
+	static const size_t value = ContextSize<H>::value + ContextSizeSum<T...>::value;
+};
+
+/*
+ * Are all arguments A... 'direct'?
+ */
+template <typename ...A> struct DirectArgs;
+
+template <> struct DirectArgs<> {
+	static const bool value = true;
+};
+
+template <typename H, typename ...T> struct DirectArgs<H, T...> {
+	static const bool value = DirectArg<H>::value && DirectArgs<T...>::value;
+};
+
+/*
+ * Can converting an argument of type T throw? Deduced from the
+ * declaration of Convert<T>::getArg, i.e., a converter is marked
+ * non-throwing by declaring its getArg 'noexcept'
+ * (IOCSH_DECL_WRAPPER_NOEXCEPT). Alternatively, specialize
+ * NoThrowArg (USER = 0). If you override a non-throwing built-in
+ * converter with one that may throw then its getArg must not be
+ * declared 'noexcept'.
+ */
+template <typename T, typename R = T, int USER = 0> struct NoThrowArg {
+	static const bool value = noexcept( Convert<T>::getArg( (const iocshArgBuf*)0, (Context*)0, 0 ) );
+};
+
+template <typename ...A> struct NoThrowArgs;
+
+template <> struct NoThrowArgs<> {
+	static const bool value = true;
+};
+
+template <typename H, typename ...T> struct NoThrowArgs<H, T...> {
+	static const bool value = NoThrowArg<H>::value && NoThrowArgs<T...>::value;
+};
+
+/*
+ * Can user function 'f' throw? Functions declared 'noexcept' are
+ * detected automatically (C++17; 'noexcept' is not part of the type
+ * in earlier versions). Other functions which are known not to throw
+ * (e.g., C functions) may be marked by specializing this template:
+ *
+ *   template <> struct NoThrowFunc<decltype(myCFunc), myCFunc> {
+ *     static const bool value = true;
+ *   };
+ */
+template <typename F, F *f, int USER = 0> struct NoThrowFunc {
+	static const bool value = false;
+};
+
+/*
+ * Can printing the result or the mutable arguments of 'f' throw?
+ * Deduced from the declaration of the 'print' member of the printer
+ * selected for 'f' (Printer, PrinterBase); the built-in printers are
+ * declared 'noexcept' (unless they use a PrintFmts which may throw).
+ * The default ArgPrinter never throws; a user ArgPrinter must declare
+ * its 'printArgs' 'noexcept'. Arguments which are all 'direct' are
+ * not printed.
+ */
+template <typename R, typename SIG, SIG *sig> struct NoThrowResultPrint {
+	typedef typename SharedPrinter< Printer<R, SIG, sig>, R >::type P;
+	static const bool value = noexcept( PrintVia<P, R>::print( *(PrintBuffer*)0, std::declval<typename Reference<R>::const_type>() ) );
+};
+
+template <typename SIG, SIG *sig> struct NoThrowResultPrint<void, SIG, sig> {
+	static const bool value = true;
+};
+
+template <typename F, F *f, int USER = 0> struct NoThrowPrint;
+
+template <typename R, typename ...A, R (*f)(A...), int USER> struct NoThrowPrint<R(A...), f, USER> {
+	static const bool value = NoThrowResultPrint<R, R(A...), f>::value
+	                          && ( DirectArgs<A...>::value || noexcept( ArgPrinter<R(A...), f>::printArgs( (Context*)0 ) ) );
+};
+
+/*
+ * Can the wrapper for 'f' (declared 'noexcept' if NX) throw? If
+ * neither the conversion of any argument nor 'f' nor printing can
+ * throw then the wrapper omits all exception handlers.
+ */
+template <typename F, F *f, bool NX = false> struct NoThrowCall;
+
+template <typename R, typename ...A, R (*f)(A...), bool NX> struct NoThrowCall<R(A...), f, NX> {
+	static const bool value = NoThrowArgs<A...>::value && ( NX || NoThrowFunc<R(A...), f>::value ) && NoThrowPrint<R(A...), f>::value;
+};
+
+/*
+ * Pack of integers 0..N-1 for indexing 'iocshArgBuf'.
+ * C++14 provides this in the standard library. The C++11 fallback
+ * builds the pack by halving N (logarithmic instantiation depth) and
+ * depends on the arity only, i.e., is shared by all signatures with
+ * the same number of arguments.
+ */
+#if __cplusplus >= 201402L
+template <size_t ...I> using Indices    = std::index_sequence<I...>;
+template <size_t N>    using MakeIndices = std::make_index_sequence<N>;
+#else
+template <size_t ...I> struct Indices {};
+
+template <typename L, typename R> struct CatIndices;
+
+template <size_t ...L, size_t ...R> struct CatIndices< Indices<L...>, Indices<R...> > {
+	typedef Indices<L..., ( sizeof...(L) + R )...> type;
+};
+
+template <size_t N> struct MakeIndicesHelper {
+	typedef typename CatIndices<
+	          typename MakeIndicesHelper<     N/2 >::type,
+	          typename MakeIndicesHelper< N - N/2 >::type
+	        >::type type;
+};
+
+template <> struct MakeIndicesHelper<0> { typedef Indices<>  type; };
+template <> struct MakeIndicesHelper<1> { typedef Indices<0> type; };
+
+template <size_t N> using MakeIndices = typename MakeIndicesHelper<N>::type;
+#endif
+
+/*
+ * The order in which arguments passed to a function are evaluated
+ * is not defined; we therefore cannot simply expand
+ *
+ *  f( Convert<A,A>::getArg( args++ )... )
+ *
+ * because we don't know in which order A... will be evaluated.
+ * Instead, every argument is paired with its index I... and
+ * converted independently.
+ */
+template <typename ...A> struct ArgOrder {
+
+	/* Size of the context arena required for converting A... */
+	static const size_t ctxSize = ContextSizeSum<A...>::value;
+
+	/* Once we have a pair of parameter packs: A... I... we can expand */
+	template <typename R, size_t ...I>
+	static R expand(R (*f)(A...), const iocshArgBuf *args, Context *ctx, Indices<I...>)
+	{
+		return f( Convert<A>::getArg( &args[I], ctx, (int)I )... );
+	}
+
+	/* Build index pack and dispatch 'f' */
+	template <typename R> static R arrange( R(*f)(A...), const iocshArgBuf *args, Context *ctx)
+	{
+		return expand( f, args, ctx, MakeIndices<sizeof...(A)>() );
 	}
 
 	/*
-	 * Build a iocshFuncDef with associated iocArg structs.
-	 * If we were to wrap huge masses of user functions then
-	 * we could keep a cache of most used iocArgs (same epics type,
-	 * same help string) around but ATM we don't bother...
+	 * Call 'f' with the converted arguments 'p' and evaluate the result
+	 * unless a conversion failed (Context::fail()). All arguments are
+	 * converted before the body is entered.
 	 */
-	template <typename R, typename ...A>
-	static iocshFuncDef  *buildArgs( const char *fname, R (*f)(A...), std::initializer_list<const char *> argNames )
+	template <typename E, typename R, typename ...P>
+	static void guard(E &res, Context *ctx, R (*f)(A...), P && ...p)
 	{
-		std::initializer_list<const char*>::const_iterator it;
-
-		FuncDef     funcDef( fname, sizeof...(A) );
-		// use array initializer to ensure order of execution
-		iocshArg   *argp[] = { (makeArg<A>())... };
-		if ( sizeof...(A) != funcDef.getNargs() ) {
-			throw std::runtime_error("IocshDeclWrapper: internal error - number of argument mismatch");
-		}
-		it              = argNames.begin();
-		for ( int i = 0; i < funcDef.getNargs(); i++ ) {
-			if ( it != argNames.end() ) {
-				if (*it) {
-					argp[i]->name = *it;
-				}
-				++it;
-			}
-			if ( argp[i]->name ) {
-				argp[i]->name = epicsStrDup( argp[i]->name );
-			}
-			funcDef.setArg(i, argp[i]);
+		if ( ! ctx->getError() ) {
+			( res, f( std::forward<P>( p )... ) ); /* <== magic 'operator,' */
 		}
-		return funcDef.release();
 	}
-};
 
-/* Specialization used when we are given an explicit signature
- */
-template <typename T, typename ...SIG> struct DropBraces<T(SIG...)> {
-
-	template <typename R>
-	static DropBraces<void>::TypeHelper<R,SIG...> type(R (*f)(SIG...))
+	/* Nothing to evaluate */
+	template <typename E, typename ...P>
+	static void guard(E &res, Context *ctx, void (*f)(A...), P && ...p)
 	{
-		return DropBraces<void>::TypeHelper<R, SIG...>();
+		if ( ! ctx->getError() ) {
+			f( std::forward<P>( p )... );
+		}
 	}
 
-	template <typename R, typename C>
-	static DropBraces<void>::MemberTypeHelper<R,C,SIG...> memberType(R (C::*f)(SIG...))
+	template <typename E, typename R, size_t ...I>
+	static void expandGuarded(E &res, R (*f)(A...), const iocshArgBuf *args, Context *ctx, Indices<I...>)
 	{
-		return DropBraces<void>::MemberTypeHelper<R, C, SIG...>();
+		guard( res, ctx, f, Convert<A>::getArg( &args[I], ctx, (int)I )... );
 	}
 
-
-	template <typename R>
-	static iocshFuncDef  *buildArgs( const char *fname, R (*f)(SIG...), std::initializer_list<const char *> argNames )
+	/* As 'arrange' but 'f' is not called if a conversion failed; the result is passed to 'res' */
+	template <typename E, typename R> static void arrangeGuarded( E &res, R(*f)(A...), const iocshArgBuf *args, Context *ctx)
 	{
-		return DropBraces<void>::buildArgs<R, SIG...>( fname, f, argNames );
+		expandGuarded( res, f, args, ctx, MakeIndices<sizeof...(A)>() );
 	}
 };
 
 /*
- * Helper struct to build a parameter pack of integers for indexing
- * 'iocshArgBuf'.
- * This is necessary because the order in which arguments passed
- * to a function is not defined; we therefore cannot simply
- * expand
- *
- *  f( Convert<A,A>::getArg( args++ )... )
- *
- * because we don't know in which order A... will be evaluated.
+ * Use template argument deduction to figure out types 'A' and 'R' automatically
+ * so that the correct Guesser can be instantiated.
  */
-template <typename ...A> struct ArgOrder {
-
-	template <int ... I> struct Index {
-		/* Once we have a pair of parameter packs: A... I... we can expand */
-		template <typename R> static R dispatch(R (*f)(A...), const iocshArgBuf *args, Context *ctx)
-		{
-			return f( Convert<A>::getArg( &args[I], ctx, I )... );
-		}
-	};
+template <typename SIG, typename R, typename ...A> Guesser<R, SIG> makeGuesser(R (*f)(A...))
+{
+	return Guesser<R, SIG>();
+}
 
-	/* Recursively build I... */
-	template <int i, int ...I> struct C {
-		template <typename R> static R concat(R (*f)(A...), const iocshArgBuf *args, Context *ctx)
-		{
-			return C<i-1, i-1, I...>::concat(f, args, ctx);
+/*
+ * Execute the user function (the 'Thunk' run by WrapperCall::invoke());
+ * the general case uses a Context, prints mutable arguments and
+ * returns the message of a conversion failure reported by
+ * Context::fail() (NULL on success).
+ */
+template <bool DIRECT> struct Dispatcher {
+	template <bool PRINT, typename R, typename ...A>
+	static const char *dispatch(R (*f)(A...), const iocshArgBuf *args, typename EvalResult<R>::PrinterType printer, ArgPrinterType printArgs, PrintBuffer *out, bool doPrint)
+	{
+		InlineContext< sizeof...(A), ArgOrder<A...>::ctxSize > ctx( args, out );
+		EvalResult<R, PRINT> res( doPrint ? printer : 0, out );
+		ArgOrder<A...>::arrangeGuarded( res, f, args, &ctx );
+		if ( ctx.getError() ) {
+			return ctx.getError();
 		}
-	};
-
-	/* Specialization for terminating the recursion */
-	template <int ...I> struct C<0, I...> {
-		template <typename R> static R concat(R (*f)(A...), const iocshArgBuf *args, Context *ctx)
-		{
-			return Index<I...>::dispatch(f, args, ctx);
+		if ( PRINT && doPrint ) {
+			WrapperCall::printArgs( printArgs, &ctx );
 		}
-	};
+		return 0;
+	}
+};
 
-	/* Build index pack and dispatch 'f' */
-	template <typename R> static R arrange( R(*f)(A...), const iocshArgBuf *args, Context *ctx)
+/*
+ * All arguments are 'direct' (by-value scalars); they are taken
+ * straight from the iocshArgBuf - no Context is needed and there
+ * are no mutable arguments to print.
+ */
+template <> struct Dispatcher<true> {
+	template <bool PRINT, typename R, typename ...A>
+	static const char *dispatch(R (*f)(A...), const iocshArgBuf *args, typename EvalResult<R>::PrinterType printer, ArgPrinterType, PrintBuffer *out, bool doPrint)
 	{
-		return C<sizeof...(A)>::concat( f, args, ctx );
+		( EvalResult<R, PRINT>( doPrint ? printer : 0, out ), /* <== magic 'operator,' */
+		  ArgOrder<A...>::arrange( f, args , 0 ) );
+		return 0;
 	}
 };
 
 /*
- * Use template argument deduction to figure out types 'A' and 'R' automatically
- * so that the correct Guesser can be instantiated.
+ * Shared by all user functions with the same signature (hence not inlined into 'thunk');
+ * the NOTHROW variant needs no unwinding.
  */
-template <typename SIG, typename R, typename ...A> Guesser<R, SIG> makeGuesser(R (*f)(A...))
+template <bool PRINT, bool NOTHROW, typename R, typename ...A>
+static IOCSH_DECL_WRAPPER_NOINLINE const char *
+dispatch(R (*f)(A...), const iocshArgBuf *args, typename EvalResult<R>::PrinterType printer, ArgPrinterType printArgs, PrintBuffer *out, bool doPrint) noexcept(NOTHROW)
 {
-	return Guesser<R, SIG>();
+	return Dispatcher< DirectArgs<A...>::value >::template dispatch<PRINT>( f, args, printer, printArgs, out, doPrint );
 }
 
-template <bool PRINT, typename R, typename ...A>
-static void
-dispatch(R (*f)(A...), const iocshArgBuf *args, typename EvalResult<R>::PrinterType printer, ArgPrinterType printArgs)
+/*
+ * The WrapperCall::Thunk for user function 'p'
+ */
+template <typename RR, RR *p, bool PRINT, bool NOTHROW> const char *thunk(const iocshArgBuf *args, PrintBuffer *out, bool doPrint) noexcept(NOTHROW)
+{
+	return dispatch<PRINT, NOTHROW>( p, args, makeGuesser<RR>( p ).template getPrinter<p>(), makeGuesser<RR>( p ).template getArgPrinter<p>(), out, doPrint );
+}
+
+/*
+ * This is the 'iocshCallFunc'; NX: 'p' is declared 'noexcept'
+ */
+template <typename RR, RR *p, bool PRINT=true, bool NX=false> void call(const iocshArgBuf *args)
 {
-	try {
-		Context ctx( args, sizeof...(A) );
-		( EvalResult<R, PRINT>( printer ), /* <== magic 'operator,' */
-		  ArgOrder<A...>::arrange( f, args , &ctx ) );
-		if ( PRINT ) {
-			printArgs( &ctx );
-		}
-	} catch ( ConversionError &e ) {
-		errlogPrintf( "Error: Invalid Argument -- %s\n", e.what() );
-	} catch ( std::exception &e ) {
-		errlogPrintf( "Error: Exception -- %s\n", e.what() );
-	} catch ( ... ) {
-		errlogPrintf( "Error: Unknown Exception\n" );
-        }
+	static const bool NOTHROW = NoThrowCall<RR, p, NX>::value;
+	( NOTHROW ? WrapperCall::invokeNoThrow : WrapperCall::invoke )( &PerWrapper<RR, p>::state, args, PRINT, thunk<RR, p, PRINT, NOTHROW> );
 }
 
+#if IOCSH_DECL_WRAPPER_PARALLEL
+/*
+ * The calls of a parallel broadcast: up to ParallelPool::concurrency()
+ * workers (jobs of the pool plus the calling thread) take the next
+ * object from a shared index until all are done. Every worker records
+ * into its own table; the tables are merged when all workers have
+ * finished.
+ */
+template <typename R, typename C, typename ...A> class ParallelBroadcast {
+private:
+	typedef DropBraces<void>::MemberTypeHelper<R, C, A...>   Helper;
+	typedef typename Helper::Match                           Match;
+	typedef std::tuple<typename Reference<A>::const_type...> Args;
+
+	struct Worker {
+		ParallelBroadcast *pb;
+		BroadcastTable<R>  part;
+	};
+
+	typedef void (*Work)(ParallelBroadcast *, Worker *);
+
+	const std::vector<Match> &objs_;
+	Args                      args_;
+	Work                      work_;
+	size_t                    next_;    /* next object to call   */
+	size_t                    running_; /* workers not yet done  */
+	int                       aborted_;
+	epicsEventId              done_;
+	std::vector<Worker>       workers_;
+
+	ParallelBroadcast(const std::vector<Match> &objs, const Args &args, Work work, size_t n)
+	: objs_   ( objs ),
+	  args_   ( args ),
+	  work_   ( work ),
+	  next_   ( 0    ),
+	  running_( n    ),
+	  aborted_( 0    ),
+	  done_   ( ParallelPool::getEvent() ),
+	  workers_( n    )
+	{
+	}
+
+	~ParallelBroadcast()
+	{
+		ParallelPool::putEvent( done_ );
+	}
+
+	template <R (C::*f)(A...), size_t ...I>
+	void callAll(BroadcastTable<R> *part, Indices<I...>)
+	{
+	size_t i;
+		while ( ( i = epicsAtomicIncrSizeT( &next_ ) - 1 ) < objs_.size() ) {
+			Helper::template record<f>( part, objs_[i], std::get<I>( args_ )... );
+		}
+	}
+
+	template <R (C::*f)(A...)>
+	static void work(ParallelBroadcast *pb, Worker *w)
+	{
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+		try {
+#endif
+			pb->template callAll<f>( &w->part, MakeIndices<sizeof...(A)>() );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+		} catch ( ... ) {
+			/* e.g., std::bad_alloc while recording a result */
+			epicsAtomicSetIntT( &pb->aborted_, 1 );
+		}
+#endif
+	}
+
+	/* A worker is done; true for the last one */
+	bool finish()
+	{
+		return 0 == epicsAtomicDecrSizeT( &running_ );
+	}
+
+	/* The last job wakes up the calling thread ('pb' is gone once it is woken) */
+	static void job(void *arg, epicsJobMode mode)
+	{
+	Worker       *w    = static_cast<Worker *>( arg );
+	epicsEventId  done = w->pb->done_;
+		if ( epicsJobModeRun == mode ) {
+			w->pb->work_( w->pb, w );
+		}
+		if ( w->pb->finish() ) {
+			epicsEventSignal( done );
+		}
+	}
+
+public:
+	template <R (C::*f)(A...)>
+	static void run(BroadcastTable<R> *tbl, const std::vector<Match> &objs, typename Reference<A>::const_type...args)
+	{
+	size_t                 n    = ParallelPool::concurrency( objs.size() );
+	epicsThreadPool       *pool = ParallelPool::pool();
+	std::vector<epicsJob*> jobs;
+	epicsJob              *j;
+	size_t                 k;
+
+		if ( n < 2 || ! pool ) {
+			for ( k = 0; k < objs.size(); k++ ) {
+				Helper::template record<f>( tbl, objs[k], args... );
+			}
+			return;
+		}
+
+		ParallelBroadcast pb( objs, Args( args... ), work<f>, n );
+
+		/* nothing may throw once jobs are queued until they are done */
+		jobs.reserve( n );
+		for ( k = 0; k < n; k++ ) {
+			pb.workers_[k].pb = &pb;
+			pb.workers_[k].part.printer = tbl->printer;
+		}
+		for ( k = 1; k < n; k++ ) {
+			if ( ( j = epicsJobCreate( pool, job, &pb.workers_[k] ) ) && 0 == epicsJobQueue( j ) ) {
+				jobs.push_back( j );
+			} else {
+				/* the others (at least the calling thread) do this worker's share */
+				if ( j ) {
+					epicsJobDestroy( j );
+				}
+				pb.finish();
+			}
+		}
+		work<f>( &pb, &pb.workers_[0] );
+		if ( ! pb.finish() ) {
+			epicsEventMustWait( pb.done_ );
+		}
+		for ( k = 0; k < jobs.size(); k++ ) {
+			epicsJobDestroy( jobs[k] );
+		}
+		for ( k = 0; k < n; k++ ) {
+			tbl->append( pb.workers_[k].part );
+		}
+		if ( pb.aborted_ ) {
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+			throw std::runtime_error( "parallel broadcast: a worker failed; results are incomplete" );
+#else
+			::abort();
+#endif
+		}
+	}
+};
+#endif
+
 /*
- * This is the 'iocshCallFunc'
+ * The 'iocshCallFunc' of a member wrapper 'p'. If the object name is a
+ * glob pattern the call is broadcast to all matching objects by 'b'
+ * (MemberTypeHelper::broadcast); both are accounted to 'p'.
  */
-template <typename RR, RR *p, bool PRINT=true> void call(const iocshArgBuf *args)
+template <typename RR, RR *p, typename BR, BR *b, bool PRINT=true, bool NX=false> void memberCall(const iocshArgBuf *args)
 {
-	dispatch<PRINT>( p, args, makeGuesser<RR>( p ).template getPrinter<p>(), makeGuesser<RR>( p ).template getArgPrinter<p>() );
+	if ( isObjectPattern( args[0].sval ) ) {
+		WrapperCall::invoke( &PerWrapper<RR, p>::state, args, PRINT, thunk<BR, b, PRINT, false> );
+	} else {
+		call<RR, p, PRINT, NX>( args );
+	}
 }
 
 }
@@ -1347,93 +5661,133 @@ template <typename RR, RR *p, bool PRINT=true> void call(const iocshArgBuf *args
 #define IOCSH_FUNC_REGISTER_WRAPPER(x,signature,nm,doPrint,argHelps...) do {                     \
 	using IocshDeclWrapper::DropBraces;                                                      \
 	using IocshDeclWrapper::call;                                                            \
-	iocshRegister( DropBraces<void signature>::buildArgs( nm, x, { argHelps } ), call<decltype(DropBraces<void signature>::type(x))::FuncType, x, doPrint> );        \
+	IocshDeclWrapper::RegProbe regProbe;                                                     \
+	static decltype(DropBraces<void signature>::type(x))::FuncDefStorage funcDefStorage;     \
+	iocshRegister( DropBraces<void signature>::buildArgs( &funcDefStorage, nm, x, { argHelps } ), call<decltype(DropBraces<void signature>::type(x))::FuncType, x, doPrint, decltype(DropBraces<void signature>::type(x))::nothrow> );        \
+	IocshDeclWrapper::registerWrapper( &funcDefStorage.def, &IocshDeclWrapper::PerWrapper<decltype(DropBraces<void signature>::type(x))::FuncType, x>::state, regProbe ); \
   } while (0)
 
 #else  /* __cplusplus < 201103L */
 
 namespace IocshDeclWrapper {
 
+/*
+ * See C++11 version for comments...
+ */
+/*
+ * Number of arguments of a Caller as a compile-time constant
+ * (C++98 has no decltype); use as sizeof( callerArgs( caller ) ) - 1
+ */
+template <typename G> char (&callerArgs(G))[G::N + 1];
+
 /*
  * See C++11 version for comments...
  */
 template <typename G>
-iocshFuncDef  *buildArgs(G guess, const char *fname, const char **argNames)
+iocshFuncDef  *buildArgs(FuncDefStorage<G::N> *storage, G guess, const char *fname, const char **argNames)
 {
 	using namespace IocshDeclWrapper;
-	int             N = G::N;
-	FuncDef         funcDef( fname, N );
+	int             N   = G::N;
+	iocshFuncDef   *def = storage->init( fname );
 	const char      *aname;
 	int             n;
+	iocshArg        arg;
 
 	aname = *argNames++;
 	n     = -1;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A0_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A0_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A1_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A1_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A2_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A2_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A3_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A3_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A4_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A4_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A5_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A5_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A6_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A6_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A7_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A7_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A8_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A8_T>( &arg, aname ) );
 	if ( aname )
 		aname = *argNames++;
 
 	if ( ++n >= N )
 		goto done;
-	funcDef.setArg( n, makeArg<typename G::A9_T>( aname ) );
+	storage->setArg( n, makeArg<typename G::A9_T>( &arg, aname ) );
 	if ( aname ) /* not necessary but leave in case more args are added */
 		aname = *argNames++;
 
 done:
 
-	return funcDef.release();
+	return def;
 }
 
+/*
+ * Sum of the arena space required for converting the arguments
+ * of a Caller (unused arguments are 'void').
+ */
+template <typename A0=void, typename A1=void, typename A2=void, typename A3=void, typename A4=void,
+          typename A5=void, typename A6=void, typename A7=void, typename A8=void, typename A9=void>
+struct ContextSizes {
+	static const size_t value = ContextSize<A0>::value + ContextSize<A1>::value + ContextSize<A2>::value
+	                          + ContextSize<A3>::value + ContextSize<A4>::value + ContextSize<A5>::value
+	                          + ContextSize<A6>::value + ContextSize<A7>::value + ContextSize<A8>::value
+	                          + ContextSize<A9>::value;
+};
+
+/*
+ * InlineContext sized for the arguments of Caller 'C'
+ */
+template <typename C> class CallerContext
+: public InlineContext< C::N, ContextSizes< typename C::A0_T, typename C::A1_T, typename C::A2_T, typename C::A3_T, typename C::A4_T,
+                                            typename C::A5_T, typename C::A6_T, typename C::A7_T, typename C::A8_T, typename C::A9_T >::value > {
+public:
+	CallerContext(const iocshArgBuf *args, PrintBuffer *out)
+	: InlineContext< C::N, ContextSizes< typename C::A0_T, typename C::A1_T, typename C::A2_T, typename C::A3_T, typename C::A4_T,
+	                                     typename C::A5_T, typename C::A6_T, typename C::A7_T, typename C::A8_T, typename C::A9_T >::value >( args, out )
+	{
+	}
+};
+
 /*
  * The purpose of this template is the implementation of a iocshCallFunc wrapper
  * around the user function.
@@ -1443,21 +5797,13 @@ done:
  * (currently supported max. - 1); see below...
  */
 
-#define IOCSH_DECL_WRAPPER_DO_CALL(args...)                                              \
+#define IOCSH_DECL_WRAPPER_DO_CALL(convertedArgs...)                                     \
 	do {                                                                             \
-		try {                                                                    \
-			EvalResult<R, PRINT>(                                            \
-				Guesser<R, type>().template getPrinter<func> ()          \
-            ), func( args ); /* <= magic 'operator,' */                                  \
-			if ( PRINT ) {                                                   \
-				Guesser<R, type>().template getArgPrinter<func>()( &ctx );   \
-			}                                                                \
-		} catch ( IocshDeclWrapper::ConversionError &e ) {                       \
-			errlogPrintf( "Error: Invalid Argument -- %s\n", e.what() );     \
-		} catch ( std::exception &e ) {                                          \
-			errlogPrintf( "Error: Exception -- %s\n", e.what() );            \
-		} catch ( ... ) {                                                        \
-			errlogPrintf( "Error: Unknown Exception\n" );                    \
+		IocshDeclWrapper::CallerContext<Caller> ctx( args, out );                \
+		EvalResult<R, PRINT>( doPrint ? printer : 0, out ),                      \
+			func( convertedArgs ); /* <= magic 'operator,' */                \
+		if ( PRINT && doPrint ) {                                                \
+			IocshDeclWrapper::WrapperCall::printArgs( printArgs, &ctx );     \
 		}                                                                        \
 	} while (0)
 
@@ -1482,6 +5828,12 @@ public:
 
 	const static int N = 10;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	/* We go though all the hoops so that we can create a iocshCallFunc wrapper;
 	 * this would not be necessary if EPICS would allow us to pass context to
 	 * the iocshCallFunc but that is not possible.
@@ -1499,7 +5851,20 @@ public:
 	 */
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		/* C++98: Context::fail() throws */
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1534,9 +5899,27 @@ public:
 
 	const static int N = 9;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1570,9 +5953,27 @@ public:
 
 	const static int N = 8;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1605,9 +6006,27 @@ public:
 
 	const static int N = 7;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1639,9 +6058,27 @@ public:
 
 	const static int N = 6;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1671,9 +6108,27 @@ public:
 
 	const static int N = 5;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1702,9 +6157,27 @@ public:
 
 	const static int N = 4;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1732,9 +6205,27 @@ public:
 
 	const static int N = 3;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 ),
@@ -1761,9 +6252,27 @@ public:
 
 	const static int N = 2;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 ),
 			IocshDeclWrapper::Convert<A1>::getArg( &args[1], &ctx, 1 )
@@ -1790,9 +6299,27 @@ public:
 
 	const static int N = 1;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL(
 			IocshDeclWrapper::Convert<A0>::getArg( &args[0], &ctx, 0 )
 		);
@@ -1818,9 +6345,27 @@ public:
 
 	const static int N = 0;
 
+	/* run-time state (see PerWrapper) */
+	template <type *func> static IocshDeclWrapper::WrapperState *wrapperState()
+	{
+		return &IocshDeclWrapper::PerWrapper<type, func>::state;
+	}
+
 	template <type *func, bool PRINT> static void call(const iocshArgBuf *args)
 	{
-		IocshDeclWrapper::Context ctx( args, N );
+		IocshDeclWrapper::WrapperCall::invoke( wrapperState<func>(), args, PRINT, thunk<func, PRINT> );
+	}
+
+	template <type *func, bool PRINT> static const char *thunk(const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
+		dispatch<PRINT>( func, Guesser<R, type>().template getPrinter<func>(), Guesser<R, type>().template getArgPrinter<func>(), args, out, doPrint );
+		return 0;
+	}
+
+	/* Shared by all user functions with this signature */
+	template <bool PRINT> static IOCSH_DECL_WRAPPER_NOINLINE void dispatch(type *func, typename Guesser<R, type>::PrinterType printer, IocshDeclWrapper::ArgPrinterType printArgs,
+	                                                                       const iocshArgBuf *args, IocshDeclWrapper::PrintBuffer *out, bool doPrint)
+	{
 		IOCSH_DECL_WRAPPER_DO_CALL();
 	}
 };
@@ -2054,10 +6599,14 @@ struct DropBraces<T(void)> {
 #define IOCSH_FUNC_WRAP_MAX_ARGS 10
 
 #define IOCSH_FUNC_REGISTER_WRAPPER(x,signature,nm,doPrint,argHelps...) do {                    \
+	IocshDeclWrapper::RegProbe regProbe;                                                    \
 	const char *argNames[IOCSH_FUNC_WRAP_MAX_ARGS + 1] = { argHelps };                      \
 	using IocshDeclWrapper::buildArgs;                                                      \
+	using IocshDeclWrapper::callerArgs;                                                     \
 	using IocshDeclWrapper::DropBraces;                                                     \
-	iocshRegister( buildArgs( DropBraces<void signature>::makeCaller(x), nm, argNames ), DropBraces<void signature>::makeCaller(x).call<x,doPrint> );  \
+	static IocshDeclWrapper::FuncDefStorage< sizeof( callerArgs( DropBraces<void signature>::makeCaller(x) ) ) - 1 > funcDefStorage; \
+	iocshRegister( buildArgs( &funcDefStorage, DropBraces<void signature>::makeCaller(x), nm, argNames ), DropBraces<void signature>::makeCaller(x).call<x,doPrint> );  \
+	IocshDeclWrapper::registerWrapper( &funcDefStorage.def, DropBraces<void signature>::makeCaller(x).wrapperState<x>(), regProbe ); \
 	} while (0)
 
 #endif /* __cplusplus >= 201103L */
@@ -2065,6 +6614,7 @@ struct DropBraces<T(void)> {
 #define IOCSH_FUNC_WRAP_REGISTRAR( registrarName, wrappers... ) \
 static void registrarName() \
 { \
+  IocshDeclWrapper::RegistrarScope registrarScope( #registrarName ); \
   wrappers \
 } \
 epicsExportRegistrar( registrarName ); \
@@ -2077,11 +6627,47 @@ epicsExportRegistrar( registrarName ); \
 #if __cplusplus >= 201103L
 #define IOCSH_MFUNC_WRAPPER(cls,memb,signature,map) decltype(DropBraces<void signature>::memberType( &cls::memb ))::template wrapper< &cls::memb, decltype(map), map>
 
+#define IOCSH_MBCAST_WRAPPER_VIA(how,cls,memb,signature,map) decltype(DropBraces<void signature>::memberType( &cls::memb ))::template how< &cls::memb, decltype(map), map>
+#define IOCSH_MBCAST_WRAPPER(cls,memb,signature,map) IOCSH_MBCAST_WRAPPER_VIA( broadcast, cls, memb, signature, map )
+
+/* Like IOCSH_FUNC_REGISTER_WRAPPER; 'objName' may also be a glob pattern (broadcast by MemberTypeHelper::how) */
+#define IOCSH_MEMBER_REGISTER_WRAPPER_VIA(how,map,cls,memb,signature,nm,doPrint,argHelps...) do {                          \
+	using IocshDeclWrapper::DropBraces;                                                                                  \
+	using IocshDeclWrapper::memberCall;                                                                                  \
+	IocshDeclWrapper::RegProbe regProbe;                                                                                 \
+	typedef decltype(DropBraces<void>::type(IOCSH_MFUNC_WRAPPER(cls, memb, signature, map)))            IocshWrapT;       \
+	typedef decltype(DropBraces<void>::type(IOCSH_MBCAST_WRAPPER_VIA(how, cls, memb, signature, map))) IocshBcastT;      \
+	static IocshWrapT::FuncDefStorage funcDefStorage;                                                                    \
+	iocshRegister( DropBraces<void>::buildArgs( &funcDefStorage, nm, IOCSH_MFUNC_WRAPPER(cls, memb, signature, map), { "objName", argHelps } ), \
+	               memberCall<IocshWrapT::FuncType, IOCSH_MFUNC_WRAPPER(cls, memb, signature, map), IocshBcastT::FuncType, IOCSH_MBCAST_WRAPPER_VIA(how, cls, memb, signature, map), doPrint, IocshWrapT::nothrow> ); \
+	IocshDeclWrapper::registerWrapper( &funcDefStorage.def, &IocshDeclWrapper::PerWrapper<IocshWrapT::FuncType, IOCSH_MFUNC_WRAPPER(cls, memb, signature, map)>::state, regProbe ); \
+  } while (0)
+
+#define IOCSH_MEMBER_REGISTER_WRAPPER(map,cls,memb,signature,nm,doPrint,argHelps...) \
+	IOCSH_MEMBER_REGISTER_WRAPPER_VIA( broadcast, map, cls, memb, signature, nm, doPrint, argHelps )
+
+/* Broadcasts run on the ParallelPool */
+#if IOCSH_DECL_WRAPPER_PARALLEL
+#define IOCSH_MEMBER_REGISTER_WRAPPER_PARALLEL(map,cls,memb,signature,nm,doPrint,argHelps...) do {                         \
+	IocshDeclWrapper::ParallelPool::init();                                                                              \
+	IOCSH_MEMBER_REGISTER_WRAPPER_VIA( broadcastParallel, map, cls, memb, signature, nm, doPrint, argHelps );             \
+  } while (0)
+#else
+#define IOCSH_MEMBER_REGISTER_WRAPPER_PARALLEL(map,cls,memb,signature,nm,doPrint,argHelps...) \
+	IOCSH_MEMBER_REGISTER_WRAPPER( map, cls, memb, signature, nm, doPrint, argHelps )
+#endif
+
 #define IOCSH_MEMBER_WRAP_OVLD(map, cls, memb, signature, nm, argHelps...) \
-	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( cls, memb, signature, map ), , nm, true, "objName", argHelps )
+	IOCSH_MEMBER_REGISTER_WRAPPER( map, cls, memb, signature, nm, true, argHelps )
 
 #define IOCSH_MEMBER_WRAP(     map, cls, memb,                argHelps...) \
-	IOCSH_FUNC_REGISTER_WRAPPER( IOCSH_MFUNC_WRAPPER( cls, memb,          , map ), , #cls"_"#memb, true, "objName", argHelps )
+	IOCSH_MEMBER_REGISTER_WRAPPER( map, cls, memb,          , #cls"_"#memb, true, argHelps )
+
+#define IOCSH_MEMBER_WRAP_PARALLEL_OVLD(map, cls, memb, signature, nm, argHelps...) \
+	IOCSH_MEMBER_REGISTER_WRAPPER_PARALLEL( map, cls, memb, signature, nm, true, argHelps )
+
+#define IOCSH_MEMBER_WRAP_PARALLEL(     map, cls, memb,                argHelps...) \
+	IOCSH_MEMBER_REGISTER_WRAPPER_PARALLEL( map, cls, memb,          , #cls"_"#memb, true, argHelps )
 
 #endif
 
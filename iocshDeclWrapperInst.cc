@@ -0,0 +1,10 @@
+/*
+ * Optional companion library: the only copy of the converters and
+ * printers for common types (see IOCSH_DECL_WRAPPER_EXTERN_TEMPLATES
+ * in iocshDeclWrapper.h) and of the C interface to the trace ring.
+ * Must be built with the same compiler and C++ standard as the users
+ * of the library.
+ */
+#define IOCSH_DECL_WRAPPER_INSTANTIATE
+#define IOCSH_DECL_WRAPPER_DEFINE_C_API
+#include "iocshDeclWrapper.h"
@@ -2,7 +2,7 @@
 import re
 import sys
 
-expectedCommands = 49
+expectedCommands = 86
 
 separator=re.compile("^#####\n$")
 comment  =re.compile("^[ \t]*[#][^#].*")
@@ -82,8 +82,6 @@ c9  0 1 2 3 4 5 6 7 8 9
 c10 0 1 2 3 4 5 6 7 8 9
 ##=##my STRING myString
 ##r##0x[0-9a-f]+ [-][>] myString
-##=##Mutable arguments after execution:
-##r##arg[\[]0[]]: 0x[0-9a-f]+ [-][>] myString
 myString("myString")
 ##=##my STRINGr myStringr
 ##r##0x[0-9a-f]+ [-][>] myStringr
@@ -92,9 +90,10 @@ myString("myString")
 myStringr("myStringr")
 ##=##my const STRING mycString
 ##r##0x[0-9a-f]+ [-][>] mycString
-##=##Mutable arguments after execution:
-##r##arg[\[]0[]]: 0x[0-9a-f]+ [-][>] mycString
 mycString("mycString")
+##=##my STRREF myStrRef (8)
+##=##8 (0x00000008)
+myStrRef("myStrRef")
 ##=##my STRINGp myStringp
 ##r##0x[0-9a-f]+ [-][>] myStringp
 ##=##Mutable arguments after execution:
@@ -134,6 +133,8 @@ myComplex
 myComplex 1.234j5.678
 ##=##Printer for 'MyType' : 44
 genMyType( 44 )
+##=##7 (0x00000007)
+myLong 7
 ##r##^\n$
 testNonPrinting
 ##=##44 (0x002c)
@@ -170,5 +171,137 @@ csp("csp_foo")
 ovldInt 22 33
 ##=##Overloaded function 'ovld(overloaded)'
 ovldStr overloaded
+##=##2 (0x00000002)
+# Member wrappers (C++11); an object name with '*' or '?' calls
+# the member on all matching objects
+Dev_add ch1 1
+##=##object  result
+##=##ch1     11 (0x0000000b)
+##=##ch12    22 (0x00000016)
+##=##ch13    Error: Exception -- bus timeout
+##=##3 objects, 1 failed
+Dev_add ch1* 10
+##=##object  result
+##=##ch1     101 (0x00000065)
+##=##ch2     102 (0x00000066)
+##=##2 objects, 0 failed
+Dev_add ch? 100
+##=##No object matches 'xyz*'
+Dev_add xyz* 1
+##=##object  result
+# Parallel broadcasts print the same table
+##=##ch1     11 (0x0000000b)
+##=##ch12    22 (0x00000016)
+##=##ch13    Error: Exception -- bus timeout
+##=##ch2     12 (0x0000000c)
+##=##4 objects, 1 failed
+Dev_addParallel ch* 10
+##=##(no output)
+# iocshWrapParallelMax limits the number of concurrent calls
+var iocshWrapParallelMax 2
+##=##object  result
+##=##ch1     1 (0x00000001)
+##=##ch12    12 (0x0000000c)
+##=##ch13    13 (0x0000000d)
+##=##ch2     2 (0x00000002)
+##=##4 objects, 0 failed
+Dev_slow ch* 10
+##=##1 (0x00000001)
+# No more than 2 calls overlapped (how many did depends on the scheduling)
+devPeakWithin 2
+##=##(no output)
+var iocshWrapParallelMax 1
+##=##object  result
+##=##ch1     1 (0x00000001)
+##=##ch12    12 (0x0000000c)
+##=##ch13    13 (0x0000000d)
+##=##ch2     2 (0x00000002)
+##=##4 objects, 0 failed
+Dev_slow ch* 10
+##=##1 (0x00000001)
+devPeakWithin 1
+##=##(no output)
+var iocshWrapParallelMax 8
+##=##(no output)
+# Jobs cannot be queued: the calling thread makes all calls
+devPoolQueue 0
+##=##object  result
+##=##ch1     1 (0x00000001)
+##=##ch12    12 (0x0000000c)
+##=##ch13    13 (0x0000000d)
+##=##ch2     2 (0x00000002)
+##=##4 objects, 0 failed
+Dev_slow ch* 10
+##=##1 (0x00000001)
+devPeakWithin 1
+##=##(no output)
+devPoolQueue 1
+##r##^\n$
+# "vvvvvv Next line is *expected* to fail *********"
+# with:
+#   Error: Exception -- parallel broadcast: a worker failed; results are incomplete
+# (recording the result of ch12 runs out of memory) or, if built without
+# IOCSH_DECL_WRAPPER_PARALLEL,
+#   Error: Exception -- std::bad_alloc
+#
+Dev_failAlloc ch*2
+##=##object  result
+# The pool is still usable
+##=##ch1     11 (0x0000000b)
+##=##ch12    22 (0x00000016)
+##=##ch13    Error: Exception -- bus timeout
+##=##ch2     12 (0x0000000c)
+##=##4 objects, 1 failed
+Dev_addParallel ch* 10
+##=##(no output)
+# Run-time print suppression (empty output is matched by a single
+# pattern that does not match an empty line)
+iocshWrapQuiet c3 on
+##=##Printing globally ON
+##=##  quiet: c3
+iocshWrapQuiet
+##=##A3 0 1 2
+c3  0 1 2 3 4 5 6 7 8 9
+##=##(no output)
+var iocshWrapQuietAll 1
+##=##A2 0 1
+c2  0 1 2 3 4 5 6 7 8 9
+##=##(no output)
+var iocshWrapQuietAll 0
+##=##(no output)
+iocshWrapQuiet c* off
+##=##A3 0 1 2
+##=##9 (0x00000009)
+c3  0 1 2 3 4 5 6 7 8 9
+##=##(no output)
+iocshWrapStats myComplex reset
+##r##^\n$
+# "vvvvvv Next line is *expected* to fail *********"
+myComplex
+##r##function +calls +convErr +except +total\[ms\] +avg\[us\] +max\[us\]
+##r##myComplex +1 +1 +0 +[0-9.]+ +[0-9.]+ +[0-9.]+
+##=##Latency histogram of 'myComplex' (ns):
+##r##  \[ *[0-9]+, +[0-9]+\): 1
+iocshWrapStats myComplex
+##=##(no output)
+var iocshWrapTraceEnable 1
+##=##A2 0 1
+##=##7 (0x00000007)
+c2  0 1 2 3 4 5 6 7 8 9
+##r## +seq +time\[s\] +dur\[us\] outcome +call
+##r## +[0-9]+ +[0-9.]+ +[0-9.]+ OK +c2\(0, 1\)
+iocshWrapTrace 1
+##=##(no output)
+var iocshWrapTraceEnable 0
+##r##registrar +functions +time\[us\] +allocs +bytes +args
+##r##wrapperRegister +[1-9][0-9]* +[0-9.]+ +[0-9]+ +[0-9]+ +[0-9]+
+##r##function +registrar +time\[us\] +allocs +bytes +args
+##r##[A-Za-z0-9_]+ +wrapperRegister +[0-9.]+ +[0-9]+ +[0-9]+ +[1-9][0-9]*
+iocshWrapStartup args 1
+##r##iocshArg descriptors requested: [0-9]+
+##r##iocshArg descriptors created: +[0-9]+
+##r##iocshArg descriptors shared: +[1-9][0-9]*
+##r##bytes saved: +[1-9][0-9]*
+iocshWrapArgCache
 #####
 testCheck()
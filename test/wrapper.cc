@@ -3,18 +3,23 @@
 #include <epicsExit.h>
 #include <epicsThread.h>
 #include <epicsStdio.h>
+#include <epicsAtomic.h>
 #include <iocshDeclWrapper.h>
 #include <epicsExport.h>
 #include <string>
 #include <string.h>
 #include <complex>
+#include <map>
+#include <stdexcept>
+#include <new>
 #include <stdio.h>
+#include <stdlib.h>
 
 /* run
  *  dc -e "`grep 'testPassed[\t]*[+][+]' wrapper.cc  | wc -l` `grep 'testPassed[\t]*[-][-]' wrapper.cc  | wc -l` - p"
  * over this file
  */
-#define NUM_TESTS 39
+#define NUM_TESTS 45
 
 static int testFailed = 0;
 static int testPassed = 0;
@@ -60,6 +65,13 @@ const std::string mycString(const std::string s)
 	return s;
 }
 
+size_t myStrRef(std::pair<const char *, size_t> s)
+{
+	if ( s.second != 8 || strncmp( s.first, "myStrRef", s.second ) ) testFailed++; else testPassed++;
+	printf("my STRREF %.*s (%lu)\n", (int)s.second, s.first, (unsigned long)s.second);
+	return s.second;
+}
+
 std::string * myStringp(std::string *s)
 {
 	if ( strcmp( s->c_str(), "myStringp" ) ) testFailed++; else testPassed++;
@@ -161,6 +173,33 @@ extern "C" int c0()
 	return printf("void\n");
 }
 
+#if __cplusplus >= 201103L && IOCSH_DECL_WRAPPER_EXCEPTIONS
+/*
+ * Fault injection for broadcasts: the next 'failAllocs'
+ * allocations of the calling thread throw std::bad_alloc.
+ */
+static thread_local int failAllocs = 0;
+
+void *operator new(std::size_t sz)
+{
+void *p;
+	if ( failAllocs > 0 ) {
+		failAllocs--;
+		throw std::bad_alloc();
+	}
+	if ( ! ( p = malloc( sz ? sz : 1 ) ) ) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+/* noinline: gcc mistakes the inlined free() for a mismatch with 'new' (-Wmismatched-new-delete) */
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+	free( p );
+}
+#endif
+
 namespace IocshDeclWrapperTest {
 
 int c1(int a0)
@@ -392,6 +431,11 @@ MyType genMyType(MyType &r)
 	return r;
 }
 
+long myLong(long l)
+{
+	return l;
+}
+
 std::complex<double> myComplex(std::complex<double> val)
 {
 	if ( 1.234 != val.real() || 5.678 != val.imag() ) testFailed++; else testPassed++;
@@ -399,6 +443,106 @@ std::complex<double> myComplex(std::complex<double> val)
 	return val;
 }
 
+#if __cplusplus >= 201103L
+/* Calls of Dev::slow() in progress and their maximum */
+static size_t devBusy = 0;
+static size_t devPeak = 0;
+
+/*
+ * Objects for the member wrappers (C++11). A glob pattern as the
+ * object name calls the member on all matching objects.
+ */
+class Dev {
+	int id;
+public:
+	Dev(int id)
+	: id( id )
+	{
+	}
+
+	int add(int v)
+	{
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+		if ( 13 == id ) {
+			throw std::runtime_error( "bus timeout" );
+		}
+#endif
+		return id + v;
+	}
+
+	/* Takes 'ms' milliseconds; records the number of concurrent calls */
+	int slow(int ms)
+	{
+	size_t n = epicsAtomicIncrSizeT( &devBusy );
+	size_t p;
+		while ( ( p = epicsAtomicGetSizeT( &devPeak ) ) < n && p != epicsAtomicCmpAndSwapSizeT( &devPeak, p, n ) )
+			;
+		epicsThreadSleep( 1.0E-3 * ms );
+		epicsAtomicDecrSizeT( &devBusy );
+		return id;
+	}
+
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+	/*
+	 * ch12 makes recording its result fail (the result and then the
+	 * error message of the row cannot be allocated) which aborts the
+	 * worker. A sequential broadcast (no IOCSH_DECL_WRAPPER_PARALLEL)
+	 * fails printing the table instead; either way the command fails
+	 * without output.
+	 */
+	int failAlloc()
+	{
+		if ( 12 == id ) {
+			failAllocs = IOCSH_DECL_WRAPPER_PARALLEL ? 2 : 1;
+		}
+		return id;
+	}
+#endif
+};
+
+std::map<const std::string, Dev*> devs;
+
+/*
+ * Were there at least one and at most 'max' concurrent calls of Dev::slow()
+ * since the last call? (How many calls actually overlap depends on the
+ * scheduling.)
+ */
+int devPeakWithin(int max)
+{
+int peak = (int)epicsAtomicGetSizeT( &devPeak );
+	epicsAtomicSetSizeT( &devPeak, 0 );
+	return peak >= 1 && peak <= max;
+}
+
+/* Make queueing jobs to the pool of the parallel broadcasts fail (on == 0) */
+void devPoolQueue(int on)
+{
+#if IOCSH_DECL_WRAPPER_PARALLEL
+	epicsThreadPoolControl( IocshDeclWrapper::ParallelPool::pool(), epicsThreadPoolQueueAdd, !! on );
+#endif
+}
+
+static void devRegister()
+{
+	devs["ch1"]  = new Dev( 1 );
+	devs["ch2"]  = new Dev( 2 );
+	devs["ch12"] = new Dev( 12 );
+	devs["ch13"] = new Dev( 13 );
+	IOCSH_MEMBER_WRAP( &devs, Dev, add, "value" );
+	IOCSH_FUNC_WRAP( devPeakWithin, "max" );
+	IOCSH_MEMBER_WRAP_PARALLEL_OVLD( &devs, Dev, add, (int), "Dev_addParallel", "value" );
+	IOCSH_MEMBER_WRAP_PARALLEL( &devs, Dev, slow, "ms" );
+	IOCSH_FUNC_WRAP( devPoolQueue, "on" );
+#if IOCSH_DECL_WRAPPER_EXCEPTIONS
+	IOCSH_MEMBER_WRAP_PARALLEL( &devs, Dev, failAlloc );
+#endif
+}
+#else
+static void devRegister()
+{
+}
+#endif
+
 
 /*
  * The tests must be executed as scripted in 'test.cmd' - otherwise
@@ -461,6 +605,26 @@ public:
 	}
 };
 
+/*
+ * Override the built-in converter for 'long' with one which
+ * uses the Context; 'long' arguments are then no longer 'direct'
+ * (the Context would be NULL).
+ */
+template <> class Convert<long, long> {
+public:
+	static void setArg( iocshArg *a )
+	{
+		a->name = "long";
+		a->type = iocshArgInt;
+	}
+
+	static long getArg( const iocshArgBuf *arg, Context *ctx, int argNo )
+	{
+		testPassed++;
+		return *ctx->make<long>( arg->ival );
+	}
+};
+
 /*
  * Provide PrinterBase for MyType function results.
  */
@@ -502,6 +666,17 @@ public:
 	}
 };
 
+#if __cplusplus >= 201103L
+/*
+ * The C function `myFuncShort()` cannot throw; since the conversion
+ * of its argument cannot throw either its wrapper omits the exception
+ * handlers.
+ */
+template <> struct NoThrowFunc<short(short), myFuncShort> {
+	static const bool value = true;
+};
+#endif
+
 /*
  * A `PrinterBase` for std::complex, overriding the default one.
  *
@@ -567,6 +742,20 @@ public:
 
 #endif
 
+#if __cplusplus >= 201103L
+/*
+ * Checked after all printers have been specialized; the printers
+ * are part of the wrapper, too.
+ */
+static_assert(   NoThrowCall<short(short), myFuncShort>::value, "myFuncShort: wrapper without exception handlers expected" );
+static_assert( ! NoThrowCall<std::complex<double>(std::complex<double>), myComplex>::value, "myComplex: not marked non-throwing" );
+static_assert( ! NoThrowCall<MyType(), testNonPrinting, true>::value, "testNonPrinting: user Printer may throw" );
+
+static_assert(   DirectArg<int>::value,         "int: built-in converter is direct" );
+static_assert(   DirectArg<std::string>::value, "std::string: built-in converter is direct" );
+static_assert( ! DirectArg<long>::value,        "long: user converter uses the context" );
+#endif
+
 }
 
 using namespace IocshDeclWrapperTest;
@@ -596,11 +785,13 @@ IOCSH_FUNC_WRAP_REGISTRAR(wrapperRegister,
 	IOCSH_FUNC_WRAP( myDouble   );
 	IOCSH_FUNC_WRAP( myString   );
 	IOCSH_FUNC_WRAP( mycString  );
+	IOCSH_FUNC_WRAP( myStrRef   );
 	IOCSH_FUNC_WRAP( myStringr  );
 	IOCSH_FUNC_WRAP( myStringp  );
 	IOCSH_FUNC_WRAP( mycStringp );
 	IOCSH_FUNC_WRAP( myComplex  );
 	IOCSH_FUNC_WRAP( genMyType  );
+	IOCSH_FUNC_WRAP( myLong     );
 	IOCSH_FUNC_WRAP_QUIET( testNonPrinting  );
 	IOCSH_FUNC_WRAP( sp         );
 	IOCSH_FUNC_WRAP( csp        );
@@ -614,6 +805,7 @@ IOCSH_FUNC_WRAP_REGISTRAR(wrapperRegister,
 	IOCSH_FUNC_WRAP( cfp        );
 	IOCSH_FUNC_WRAP_OVLD( ovld, (int,    int), "ovldInt" );
 	IOCSH_FUNC_WRAP_OVLD( ovld, (const char*), "ovldStr" );
+	devRegister();
 )
 
 epicsExportAddress(int, testPassed);